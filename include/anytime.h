@@ -0,0 +1,145 @@
+#ifndef __ANYTIME_H__
+#define __ANYTIME_H__
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "coloring_base.h"
+#include "asynch_naive.h"
+#include "chromatic_executor.h"
+
+// Anytime coloring within a time budget (-deadline-ms). The naive engine
+// gives the start coloring and is stopped at the first iteration boundary
+// after the deadline; a coloring it leaves with conflicts is repaired by
+// one sequential first-fit sweep. The remaining budget goes to iterated
+// greedy passes (Culberson): the color classes of the current coloring are
+// recolored first-fit one whole class after another, in reverse, largest
+// first or shuffled order. Such a pass never uses more colors than the
+// coloring it started from, and only a pass that fails to finish before
+// the deadline is discarded. Returns the number of engine iterations;
+// firstFit is false when the result may not be a first-fit coloring.
+template <class vertex>
+uint64_t colorAnytime(graph<vertex> &GA, colorVector &colorData, const uintT maxDegree,
+                      commandLine &P, long deadlineMs, bool verbose, bool &firstFit)
+{
+    timer deadlineTimer;
+    const double startTime = deadlineTimer.getTime();
+    const double deadline = startTime + deadlineMs / 1000.0;
+    const size_t numVertices = GA.n;
+    const uintT hubDegree = P.getOptionLongValue("-hub-degree", HUB_DEGREE_DEFAULT);
+
+    // Start coloring from the naive engine, cut off at the deadline
+    bool engineDone = true;
+    const uint64_t iter = colorAsynchNaive(GA, colorData, maxDegree, P, false,
+        [&] (uint64_t, BitsetScheduler &schedule) -> bool
+        {
+            engineDone = !schedule.anyScheduledTasks();
+            return engineDone || deadlineTimer.getTime() < deadline;
+        });
+
+    // Every vertex that still conflicts takes a color no neighbour has.
+    // Later recolorings avoid all neighbour colors, so no new conflicts
+    // appear behind the sweep.
+    size_t repairedVertices = 0;
+    if (!engineDone)
+    {
+        ForbiddenColors forbiddenColors(maxDegree + 1);
+        for (size_t v_i = 0; v_i < numVertices; v_i++)
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            bool conflict = false;
+            for (uintT n_i = 0; n_i < vDegree && !conflict; n_i++)
+                conflict = (colorData[GA.V[v_i].getOutNeighbor(n_i)] == colorData[v_i]);
+            if (conflict)
+            {
+                forbiddenColors.reset(vDegree);
+                markNeighborColors(GA.V[v_i], colorData, forbiddenColors);
+                colorData[v_i] = forbiddenColors.firstFree();
+                repairedVertices++;
+            }
+        }
+    }
+    const uintT initialColors = countColors(colorData);
+    const double initialTime = deadlineTimer.getTime() - startTime;
+
+    // Iterated greedy passes until the deadline
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+    colorVector newColors = makeColorVector(numVertices, UINT_T_MAX);
+    std::mt19937 shuffleRandom(1);
+    uintT bestColors = initialColors;
+    uint64_t passes = 0;
+    uint64_t bestPass = 0;
+    bool deadlineHit = (deadlineTimer.getTime() >= deadline);
+    while (!deadlineHit)
+    {
+        ChromaticExecutor<vertex> classes(GA, colorData);
+        const uintT numColors = classes.numColors();
+        if (numColors <= 1)
+            break;
+        std::vector<uintT> order(numColors);
+        for (uintT c_i = 0; c_i < numColors; c_i++)
+            order[c_i] = numColors - 1 - c_i;
+        if (passes % 3 == 1)
+        {
+            std::stable_sort(order.begin(), order.end(), [&] (uintT a, uintT b)
+            {
+                return classes.classSize(a) > classes.classSize(b);
+            });
+        }
+        else if (passes % 3 == 2)
+            std::shuffle(order.begin(), order.end(), shuffleRandom);
+
+        // The vertices of a class are not adjacent, so a class is colored
+        // in parallel against the classes placed before it
+        parallel_for (0, numVertices, [&] (size_t v_i)
+        {
+            newColors[v_i] = UINT_T_MAX;
+        });
+        uintT placed = 0;
+        for (; placed < numColors; placed++)
+        {
+            if (deadlineTimer.getTime() >= deadline)
+                break;
+            classes.runClass(order[placed], [&] (uintT v_i)
+            {
+                newColors[v_i] = firstFitColor(GA.V[v_i], newColors, workerColors.local(),
+                                               GA.V[v_i].getOutDegree(), hubDegree);
+            });
+        }
+
+        // A pass cut off by the deadline is dropped
+        if (placed < numColors)
+        {
+            deadlineHit = true;
+            break;
+        }
+        passes++;
+        std::swap(colorData, newColors);
+        const uintT colorCount = countColors(colorData);
+        if (colorCount < bestColors)
+        {
+            bestColors = colorCount;
+            bestPass = passes;
+        }
+        deadlineHit = (deadlineTimer.getTime() >= deadline);
+    }
+
+    // The engine's fixpoint and every completed pass are first-fit
+    firstFit = engineDone || passes > 0;
+
+    if (verbose)
+    {
+        std::cout << std::endl;
+        std::cout << "Deadline: " << deadlineMs << " ms, " << (engineDone ? "" : "engine stopped, ")
+                  << (deadlineHit ? "reached" : "not reached") << std::endl;
+        std::cout << "\tInitial Colors: " << initialColors << " after "
+                  << setprecision(TIME_PRECISION) << initialTime * 1000 << " ms, "
+                  << repairedVertices << " repaired Vs" << std::endl;
+        std::cout << "\tBest Colors: " << bestColors << " from pass " << bestPass << std::endl;
+        std::cout << "\tGreedy Passes: " << passes << std::endl;
+    }
+    return iter;
+}
+
+#endif
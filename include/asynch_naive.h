@@ -0,0 +1,130 @@
+#ifndef __ASYNCH_NAIVE_H__
+#define __ASYNCH_NAIVE_H__
+
+#include "coloring_base.h"
+
+// Naive asynchronous coloring: every scheduled vertex takes the smallest
+// color no neighbour has and, when its color changes, schedules the
+// neighbours it may now conflict with or free a color for, until nothing
+// is scheduled. colorData holds the starting colors. After every
+// iteration iterationDone(iter, schedule) is called, and the engine stops
+// early when it returns false. Returns the number of iterations.
+template <class vertex, class F>
+uint64_t colorAsynchNaive(graph<vertex> &GA, colorVector &colorData, const uintT maxDegree,
+                          commandLine &P, bool verbose, F iterationDone)
+{
+    timer iterTimer;
+    const size_t numVertices = GA.n;
+
+    // Verbose variables
+    uintT activeVertices;
+    uintT activeEdges;
+    uintT changedVertices;
+
+    // Make new scheduler and schedule all vertices
+    BitsetScheduler currentSchedule(numVertices);
+    currentSchedule.reset();
+    currentSchedule.scheduleAll(false);
+
+    // Vertices with at least this many neighbours are colored with nested
+    // parallelism (-hub-degree)
+    const uintT hubDegree = P.getOptionLongValue("-hub-degree", HUB_DEGREE_DEFAULT);
+
+    // Per-worker forbidden color sets for the first-fit search
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Optional software prefetching K vertices ahead of the loop (-prefetch K)
+    PrefetchPipeline<vertex, colorVector> pipeline(GA, colorData, P.getOptionLongValue("-prefetch", 0));
+    auto scheduledAt = [&] (size_t pos) -> uintT
+    {
+        return currentSchedule.isScheduled(pos) ? pos : UINT_T_MAX;
+    };
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
+
+    double lastStopTime = iterTimer.getTime();
+
+    // Loop over vertices until nothing is scheduled
+    uint64_t iter = 0;
+    while (currentSchedule.anyScheduledTasks())
+    {
+        iter++;
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << iter << std::endl;
+        }
+        activeVertices = 0;
+        activeEdges = 0;
+        changedVertices = 0;
+
+        currentSchedule.newIteration();
+        activeVertices = currentSchedule.numTasks();
+
+        // Parallel loop where each vertex is assigned a color
+        vertexLoop.run([&] (uintT v_i)
+        {
+            pipeline.ahead(v_i, numVertices, scheduledAt);
+
+            if (currentSchedule.isScheduled(v_i))
+            {
+                // Get current vertex's neighbours
+                const uintT vDegree = GA.V[v_i].getOutDegree();
+                bool scheduleNeighbors = false;
+                // bool removeFromNeigh = false;
+                
+                activeEdges += vDegree;
+
+                // Mark the colors already taken by neighbours
+                // and assign the minimum color not taken by a neighbour if it
+                // is not the vertex's current value
+                uintT newColor = firstFitColor(GA.V[v_i], colorData, workerColors.local(),
+                                               vDegree, hubDegree);
+                uintT oldColor = colorData[v_i]; 
+                if (newColor <= vDegree && oldColor != newColor)
+                {
+                    colorData[v_i] = newColor;
+                    // if (newColor == minimalColor[v_i])
+                    //     removeFromNeigh = true;
+                    scheduleNeighbors = true;
+                    changedVertices++;
+                }
+
+                // Schedule all neighbours if required
+                if (scheduleNeighbors)
+                {
+                    for (uintT n_i = 0; n_i < vDegree; n_i++)
+                    {
+                        uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+                        if (oldColor < colorData[neigh] || colorData[v_i] == colorData[neigh])
+                            currentSchedule.schedule(neigh, false);
+                    }
+                }
+            }
+        });
+        if (verbose)
+        {
+            std::cout << "\tActive Vs: " << activeVertices << std::endl;
+            std::cout << "\tActive Es: " << activeEdges << std::endl;
+            std::cout << "\tModified Vs: " << changedVertices << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+        if (!iterationDone(iter, currentSchedule))
+            break;
+    }
+    vertexLoop.del();
+    return iter;
+}
+
+// Runs to convergence
+template <class vertex>
+uint64_t colorAsynchNaive(graph<vertex> &GA, colorVector &colorData, const uintT maxDegree,
+                          commandLine &P, bool verbose)
+{
+    return colorAsynchNaive(GA, colorData, maxDegree, P, verbose,
+        [] (uint64_t iter, BitsetScheduler &schedule) { return true; });
+}
+
+#endif
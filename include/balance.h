@@ -0,0 +1,170 @@
+#ifndef __BALANCE_H__
+#define __BALANCE_H__
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <vector>
+
+#include "coloring_base.h"
+#include "chromatic_executor.h"
+
+// Prints the size of every color class, the smallest and largest ones
+// and their ratio
+inline void printClassSizes(const char* label, const std::vector<long> &sizes)
+{
+    long smallest = LONG_MAX, largest = 0;
+    for (size_t c_i = 0; c_i < sizes.size(); c_i++)
+    {
+        smallest = std::min(smallest, sizes[c_i]);
+        largest = std::max(largest, sizes[c_i]);
+    }
+    std::cout << label << " class sizes:";
+    for (size_t c_i = 0; c_i < sizes.size(); c_i++)
+        std::cout << " " << sizes[c_i];
+    std::cout << std::endl;
+    if (!sizes.empty())
+    {
+        std::cout << "\tMin: " << smallest << " Max: " << largest << " Ratio: "
+                  << setprecision(3) << (smallest > 0 ? (double) largest / smallest : 0.0) << std::endl;
+    }
+}
+
+// Balanced coloring (-balance). First-fit leaves a huge class 0 and tiny
+// high classes, which starves the later phases of anything that runs
+// class by class. Every pass visits the classes above the average size
+// n/k, largest first, and moves their vertices in parallel to the
+// smallest class below the average that no neighbour has. The vertices of
+// one class are never adjacent and their neighbours do not move at the
+// same time, so moves cannot create conflicts. Class sizes are reserved
+// atomically so no class is pushed across the average. Passes stop once
+// the largest class is at most -balance-ratio times the smallest (1.1 by
+// default), after -balance-passes passes (10 by default) or when a pass
+// moves nothing. Colorings with conflicts are left alone. Returns the
+// number of vertices moved.
+template <class vertex>
+size_t balanceColors(graph<vertex> &GA, colorVector &colorData, commandLine &P)
+{
+    if (!P.getOption("-balance"))
+        return 0;
+    timer balanceTimer;
+    balanceTimer.start();
+    const double targetRatio = P.getOptionDoubleValue("-balance-ratio", 1.1);
+    const long maxPasses = P.getOptionLongValue("-balance-passes", 10);
+    const size_t numVertices = GA.n;
+    const uintT numColors = countColors(colorData);
+
+    if (countConflicts(GA, colorData) != 0)
+    {
+        std::cout << "Balance: coloring has conflicts, skipped" << std::endl;
+        return 0;
+    }
+    if (numColors < 2)
+        return 0;
+
+    std::vector<std::atomic<long>> sizes(numColors);
+    auto classSizes = [&] ()
+    {
+        std::vector<long> current(numColors);
+        for (uintT c_i = 0; c_i < numColors; c_i++)
+            current[c_i] = sizes[c_i].load();
+        return current;
+    };
+    {
+        ChromaticExecutor<vertex> classes(GA, colorData);
+        for (uintT c_i = 0; c_i < numColors; c_i++)
+            sizes[c_i].store(classes.classSize(c_i));
+    }
+    printClassSizes("Initial", classSizes());
+
+    // Classes are filled up to the rounded up average and emptied down to
+    // the rounded down one
+    const long ceilAverage = (numVertices + numColors - 1) / numColors;
+    const long floorAverage = numVertices / numColors;
+    auto ratio = [&] ()
+    {
+        std::vector<long> current = classSizes();
+        long smallest = *std::min_element(current.begin(), current.end());
+        long largest = *std::max_element(current.begin(), current.end());
+        return smallest > 0 ? (double) largest / smallest : (double) LONG_MAX;
+    };
+
+    WorkerForbiddenColors workerColors(numColors);
+    size_t totalMoved = 0;
+    long passes = 0;
+    while (passes < maxPasses && ratio() > targetRatio)
+    {
+        passes++;
+        std::atomic<size_t> moved(0);
+        ChromaticExecutor<vertex> classes(GA, colorData);
+
+        // Oversized classes, largest first
+        std::vector<uintT> sources;
+        for (uintT c_i = 0; c_i < numColors; c_i++)
+        {
+            if ((long) classes.classSize(c_i) > floorAverage)
+                sources.push_back(c_i);
+        }
+        std::sort(sources.begin(), sources.end(), [&] (uintT l, uintT r)
+        {
+            return classes.classSize(l) > classes.classSize(r);
+        });
+
+        for (size_t s_i = 0; s_i < sources.size(); s_i++)
+        {
+            const uintT source = sources[s_i];
+            classes.runClass(source, [&] (uintE v_i)
+            {
+                // Take one vertex out of the source while it is above the average
+                if (sizes[source].fetch_sub(1) <= floorAverage)
+                {
+                    sizes[source].fetch_add(1);
+                    return;
+                }
+                ForbiddenColors &forbiddenColors = workerColors.local();
+                forbiddenColors.reset(numColors - 1);
+                markNeighborColors(GA.V[v_i], colorData, forbiddenColors);
+
+                // Smallest allowed class with room left, retried when the
+                // room is taken by another vertex in the meantime
+                for (uintT attempt = 0; attempt < numColors; attempt++)
+                {
+                    uintT best = UINT_T_MAX;
+                    long bestSize = ceilAverage;
+                    for (uintT c_i = 0; c_i < numColors; c_i++)
+                    {
+                        const long size = sizes[c_i].load(std::memory_order_relaxed);
+                        if (c_i != source && size < bestSize && !forbiddenColors.isForbidden(c_i))
+                        {
+                            best = c_i;
+                            bestSize = size;
+                        }
+                    }
+                    if (best == UINT_T_MAX)
+                        break;
+                    if (sizes[best].fetch_add(1) < ceilAverage)
+                    {
+                        colorData[v_i] = best;
+                        moved++;
+                        return;
+                    }
+                    sizes[best].fetch_sub(1);
+                }
+                sizes[source].fetch_add(1);
+            });
+        }
+
+        totalMoved += moved.load();
+        std::cout << "Balance pass " << passes << ": " << moved.load() << " moved, ratio "
+                  << setprecision(3) << ratio() << std::endl;
+        if (moved.load() == 0)
+            break;
+    }
+
+    printClassSizes("Balanced", classSizes());
+    std::cout << "\tMoved Vs: " << totalMoved << std::endl;
+    std::cout << "\tTime: " << setprecision(TIME_PRECISION) << balanceTimer.stop() << std::endl;
+    return totalMoved;
+}
+
+#endif
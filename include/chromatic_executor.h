@@ -0,0 +1,100 @@
+#ifndef __CHROMATIC_EXECUTOR_H__
+#define __CHROMATIC_EXECUTOR_H__
+
+#include "coloring_base.h"
+
+// Runs vertex functions class by class over a proper coloring. No two
+// vertices of a color class are adjacent, so a function may read its
+// neighbours and update its own vertex in place without locks: within a
+// class no neighbour is written, and classes are separated by the barrier
+// at the end of each parallel_for. This gives Gauss-Seidel style sweeps
+// where every update sees the latest values of earlier classes.
+//
+// The vertices of each class are stored contiguously, grouped by a
+// parallel counting sort on their colors.
+template <class vertex>
+class ChromaticExecutor
+{
+public:
+    ChromaticExecutor(const graph<vertex> &GA, const colorVector &colorData) : numVertices(GA.n)
+    {
+        colors = 0;
+        if (numVertices > 0)
+        {
+            const uintT maxColor = sequence::reduce<uintT>((long) 0, (long) numVertices, maxF<uintT>(),
+                [&] (long v_i) { return colorData[v_i]; });
+            // An uncolored vertex would wrap the class count around
+            if (maxColor == UINT_T_MAX)
+            {
+                cout << "Chromatic executor needs every vertex colored. Exiting..." << endl;
+                exit(2);
+            }
+            colors = maxColor + 1;
+        }
+
+        classOffsets = newA(uintT, colors + 1);
+        classes = newA(uintE, numVertices);
+        parallel_for (0, numVertices, [&] (size_t v_i)
+        {
+            classes[v_i] = v_i;
+        });
+        if (numVertices > 0)
+        {
+            intSort::iSort(classes, classOffsets, numVertices, colors,
+                [&] (uintE v_i) { return colorData[v_i]; });
+        }
+        classOffsets[colors] = numVertices;
+    }
+
+    ~ChromaticExecutor()
+    {
+        free(classOffsets);
+        free(classes);
+    }
+
+    uintT numColors() const
+    {
+        return colors;
+    }
+
+    size_t classSize(uintT color) const
+    {
+        return classOffsets[color + 1] - classOffsets[color];
+    }
+
+    const uintE* classVertices(uintT color) const
+    {
+        return classes + classOffsets[color];
+    }
+
+    // Call f(v_i) for every vertex of one color class in parallel
+    template <class F>
+    void runClass(uintT color, F f) const
+    {
+        const uintE* vertices = classVertices(color);
+        const size_t size = classSize(color);
+        parallel_for (0, size, [&] (size_t c_i)
+        {
+            f(vertices[c_i]);
+        });
+    }
+
+    // One sweep: every class in color order
+    template <class F>
+    void run(F f) const
+    {
+        for (uintT c_i = 0; c_i < colors; c_i++)
+            runClass(c_i, f);
+    }
+
+private:
+    ChromaticExecutor(const ChromaticExecutor&);
+    ChromaticExecutor& operator=(const ChromaticExecutor&);
+
+    size_t numVertices;
+    uintT colors;
+    uintT* classOffsets;
+    uintE* classes;
+};
+
+#endif
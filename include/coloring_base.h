@@ -22,6 +22,9 @@
 // OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#ifndef __COLORING_BASE_H__
+#define __COLORING_BASE_H__
+
 #include <iostream>
 #include <thread>
 #include <mutex>
@@ -31,11 +34,37 @@
 #include <ctime>
 
 #include "bitsetscheduler.h"
+#include "forbidden_colors.h"
+#include "neighbor_colors.h"
+#include "neighbor_color_counts.h"
+#include "hub_colors.h"
 #include "ligra.h"
 #include "gettime.h"
+#include "graph_checks.h"
 
 #define TIME_PRECISION 3
 
+// Vertex-indexed color array, backed by huge pages with -hugepages
+typedef std::vector<uintT, hugeAllocator<uintT>> colorVector;
+
+// n colors set to value. The array is placed with the -numa options, then
+// first touched by a parallel fill so that every block of pages lands on
+// the node of the worker that fills it.
+inline colorVector makeColorVector(size_t n, uintT value)
+{
+    colorVector colors;
+    {
+        hugeUninitializedScope uninitialized;
+        colors.resize(n);
+    }
+    numaPlaceVertexArray(colors.data(), n, sizeof(uintT));
+    parallel_for (0, n, [&] (size_t v_i)
+    {
+        colors[v_i] = value;
+    });
+    return colors;
+}
+
 struct listNode
 {
     uintT vertexID;
@@ -44,51 +73,49 @@ struct listNode
 };
 
 // Go through every vertex and check that it's color does not conflict with neighbours
-// while also checking that each vertex is minimally colored
+// while also checking that each vertex is minimally colored. Post-processors
+// move vertices away from their first free color on purpose, so their output
+// is assessed with checkMinimality false.
 template <class vertex>
-void assessGraph(const graph<vertex> &GA, const std::vector<uintT> &colorData, const uintT maxDegree) 
+void assessGraph(const graph<vertex> &GA, const colorVector &colorData, const uintT maxDegree,
+                 bool checkMinimality = true)
 {
     const uintT numVertices = GA.n;
     uintT conflict = 0;
     uintT notMinimal = 0;
     uintT maxColor = 0;
+    WorkerForbiddenColors workerColors(maxDegree + 1);
 
-    parallel_for (uintT v_i = 0; v_i < numVertices; v_i++)
+    parallel_for (0, numVertices, [&] (uintT v_i)
     {
         uintT vValue = colorData[v_i];  
         uintT vDegree = GA.V[v_i].getOutDegree();
-        std::vector<bool> possibleColors(maxDegree + 1, true);
+        ForbiddenColors &forbiddenColors = workerColors.local();
+        forbiddenColors.reset(vDegree);
         if (vValue > maxColor)
             maxColor = vValue;
 
         // Check for conflict and set possible colors
         bool neighConflict = false;
-        for(uintT n_i = 0; n_i < vDegree; n_i++)
+        mapNeighborColors(GA.V[v_i], colorData, [&] (uintT neighVal)
         {
-            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-            uintT neighVal = colorData[neigh];
-            possibleColors[neighVal] = false;
-            
+            forbiddenColors.mark(neighVal);
             if (neighVal == vValue)
             {
                 neighConflict = true;
             }
-        }
+        });
         if (neighConflict)
             conflict++;
 
         // Check for minimality
-        uintT minimalColor = 0;
-        while (!possibleColors[minimalColor] && (minimalColor < vDegree + 1))
-        {
-            minimalColor++;
-        }
+        uintT minimalColor = forbiddenColors.firstFree();
 
-        if (vValue != minimalColor)
+        if (checkMinimality && vValue != minimalColor)
         {
             notMinimal++;
         }
-    }
+    });
 
     if (conflict != 0)
     {
@@ -106,27 +133,9 @@ void assessGraph(const graph<vertex> &GA, const std::vector<uintT> &colorData, c
 }
 
 
-// Find the maximum degree amongst nodes of the graph
-template <class vertex>
-uintT getMaxDeg(const graph<vertex> &GA)
-{
-    uintT maxDegree = 0;
-    // TODO: look into parallelizing this loop with CAS
-    for (uintT v_i=0; v_i < GA.n; v_i++)
-    {
-        if (GA.V[v_i].getOutDegree() > maxDegree)
-        {
-            maxDegree = GA.V[v_i].getOutDegree();
-        }
-    }
-    return maxDegree;
-}
-
-
-
 //randomize vertex values
 template <class vertex>
-void randomizeColors(graph<vertex> &GA, std::vector<uintT> &colorData)
+void randomizeColors(graph<vertex> &GA, colorVector &colorData)
 {
     const size_t numVertices = GA.n;
     std::random_device rd;
@@ -143,62 +152,89 @@ void randomizeColors(graph<vertex> &GA, std::vector<uintT> &colorData)
 
 
 
-//Check graph is undirected
-template <class vertex>
-void ensureUndirected(graph<vertex> &GA)
-{
-    for(uintT v_i = 0; v_i < GA.n; v_i++)
-    { 
-        const uintT outVDegree = GA.V[v_i].getOutDegree();
-        const uintT inVDegree = GA.V[v_i].getInDegree();
-
-        if (outVDegree != inVDegree)
-        {
-            cout << "Graph is not undirected. Exiting..." << endl;
-            exit(2);
-        }
-    }
-}
-
 template <class vertex>
 uintT makeColorPartition(graph<vertex> &GA,
                         std::vector<std::vector<uintT>> &partition,
-                        std::vector<uintT> &colorData,
+                        colorVector &colorData,
                         uintT maxDegree)
 {
     uintT changedVertices = 0;
     const size_t numVertices = GA.n;
+    ForbiddenColors forbiddenColors(maxDegree + 1);
     for(uintT v_i = 0; v_i < numVertices; v_i++)
     {
         // Get current vertex's neighbours
         const uintT vDegree = GA.V[v_i].getOutDegree();        
 
-        // Make bool array for possible color values and then set any color
-        // already taken by neighbours to false
-        std::vector<bool> possibleColors(maxDegree + 1, true);
+        // Mark the colors already taken by neighbours
+        forbiddenColors.reset(vDegree);
         
-        for (uintT n_i = 0; n_i < vDegree; n_i++)
-        {
-            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-            uintT neighVal = colorData[neigh];
-            possibleColors[neighVal] = false;  
-        }
+        markNeighborColors(GA.V[v_i], colorData, forbiddenColors);
 
-        // Find minimum color by iterating through color array in increasing order
-        uintT newColor = 0;
-        while (newColor <= vDegree)
-        {                    
-            // If color is available and it is not the vertex's current value then try to assign
-            if (possibleColors[newColor])
-            {
-                colorData[v_i] = newColor;
-                partition[newColor].push_back(v_i);
-                changedVertices++;
-                break;
-            }
-            newColor++;
-        }
+        // Assign the minimum color not taken by a neighbour
+        uintT newColor = forbiddenColors.firstFree();
+        colorData[v_i] = newColor;
+        partition[newColor].push_back(v_i);
+        changedVertices++;
     }
 
     return changedVertices;
-}
\ No newline at end of file
+}
+
+// Number of vertices having a neighbour of the same color
+template <class vertex>
+size_t countConflicts(const graph<vertex> &GA, const colorVector &colorData)
+{
+    return sequence::reduce<size_t>((long) 0, (long) GA.n, addF<size_t>(),
+        [&] (long v_i) -> size_t
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            for (uintT n_i = 0; n_i < vDegree; n_i++)
+            {
+                if (colorData[GA.V[v_i].getOutNeighbor(n_i)] == colorData[v_i])
+                    return 1;
+            }
+            return 0;
+        });
+}
+
+// Number of colors of a coloring using colors [0, k)
+inline uintT countColors(const colorVector &colorData)
+{
+    if (colorData.empty())
+        return 0;
+    return 1 + sequence::reduce<uintT>((long) 0, (long) colorData.size(), maxF<uintT>(),
+        [&] (long v_i) { return colorData[v_i]; });
+}
+
+// Hash of a coloring that does not depend on the order vertices are
+// visited in, so equal colorings always give equal hashes
+inline uint64_t coloringHash(const colorVector &colorData)
+{
+    return sequence::reduce<uint64_t>((long) 0, (long) colorData.size(), addF<uint64_t>(),
+        [&] (long v_i) { return pbbs::hash64(pbbs::hash64(v_i) + colorData[v_i]); });
+}
+
+// Post-processors, built on the helpers above
+#include "kempe.h"
+#include "balance.h"
+
+// Shared end of the engines using plain color arrays: the optional
+// post-processors run on the finished coloring, which is then assessed.
+// They move vertices away from their first free color on purpose, so
+// minimality is only checked when none of them ran and the engine gives a
+// first-fit coloring (firstFit).
+template <class vertex>
+void finishColoring(graph<vertex> &GA, colorVector &colorData, const uintT maxDegree, commandLine &P,
+                    bool firstFit = true)
+{
+    // Kempe chain color class elimination (-kempe)
+    kempeEliminate(GA, colorData, P);
+
+    // Color class balancing (-balance)
+    balanceColors(GA, colorData, P);
+
+    assessGraph(GA, colorData, maxDegree, firstFit && !P.getOption("-kempe") && !P.getOption("-balance"));
+}
+
+#endif
@@ -30,8 +30,10 @@
 #include <ctime>
 
 #include "bitsetscheduler.h"
+#include "forbidden_colors.h"
 #include "ligra.h"
 #include "gettime.h"
+#include "graph_checks.h"
 
 #define TIME_PRECISION 3
 
@@ -152,13 +154,16 @@ void releaseLocks_RC(graph<vertex> &GA, Color* &colorData, const uint v_i)
 template <class vertex>
 bool GetPossibleColors( const graph<vertex> &GA,
                         Color* &colorData,
-                        std::vector<bool> &possibleColors,
+                        ForbiddenColors &forbiddenColors,
                         const uint v_i)
 {
     const uintT vDegree = GA.V[v_i].getOutDegree();
     uintT neigh;
     int result;
 
+    // Colors marked by an earlier attempt may be stale
+    forbiddenColors.reset(vDegree + 1);
+
     // Get write lock on self and reader locks on all neighbours
     colorData[v_i].rwLock.writeLock();
     for(uintT n_i = 0; n_i < vDegree; n_i++)
@@ -195,7 +200,7 @@ bool GetPossibleColors( const graph<vertex> &GA,
         }
 
         uintT neighVal = colorData[neigh].color;
-        possibleColors[neighVal] = false;  
+        forbiddenColors.mark(neighVal);
     }
 
     return true;
@@ -205,13 +210,16 @@ bool GetPossibleColors( const graph<vertex> &GA,
 template <class vertex>
 bool GetPossibleColors_RC( const graph<vertex> &GA,
                         Color* &colorData,
-                        std::vector<bool> &possibleColors,
+                        ForbiddenColors &forbiddenColors,
                         const uint v_i)
 {
     const uintT vDegree = GA.V[v_i].getOutDegree();
     uintT neigh;
     int result;
 
+    // Colors marked by an earlier attempt may be stale
+    forbiddenColors.reset(vDegree + 1);
+
     // Get write lock on self and reader locks on all neighbours
     colorData[v_i].rwLock.writeLock();
     for(uintT n_i = 0; n_i < vDegree; n_i++)
@@ -248,7 +256,7 @@ bool GetPossibleColors_RC( const graph<vertex> &GA,
         }
 
         uintT neighVal = colorData[neigh].color;
-        possibleColors[neighVal] = false;
+        forbiddenColors.mark(neighVal);
         colorData[neigh].rwLock.unlock();
     }
 
@@ -264,12 +272,14 @@ void assessGraph(graph<vertex> &GA, Color* &colorData, uintT maxDegree)
     uintT numVertices = GA.n;
     uintT conflict = 0;
     uintT notMinimal = 0;
+    WorkerForbiddenColors workerColors(maxDegree + 1);
 
-    parallel_for(uintT v_i = 0; v_i < numVertices; v_i++)
+    parallel_for(0, numVertices, [&] (uintT v_i)
     {
         Color vValue = colorData[v_i];  
         uintT vDegree = GA.V[v_i].getOutDegree();
-        std::vector<bool> possibleColors(maxDegree + 1, true);
+        ForbiddenColors &forbiddenColors = workerColors.local();
+        forbiddenColors.reset(vDegree);
 
         // Check for conflict and set possible colors
         bool neighConflict = false;
@@ -277,7 +287,7 @@ void assessGraph(graph<vertex> &GA, Color* &colorData, uintT maxDegree)
         {
             uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
             Color neighVal = colorData[neigh];
-            possibleColors[neighVal.color] = false;
+            forbiddenColors.mark(neighVal.color);
             
             if (neighVal == vValue)
             {
@@ -288,17 +298,13 @@ void assessGraph(graph<vertex> &GA, Color* &colorData, uintT maxDegree)
             conflict++;
 
         // Check for minimality
-        Color minimalColor = 0;
-        while (!possibleColors[minimalColor.color] && (minimalColor < vDegree + 1))
-        {
-            minimalColor++;
-        }
+        Color minimalColor = forbiddenColors.firstFree();
 
         if (vValue != minimalColor)
         {
             notMinimal++;
         }
-    }
+    });
 
     if (conflict != 0)
     {
@@ -315,20 +321,15 @@ void assessGraph(graph<vertex> &GA, Color* &colorData, uintT maxDegree)
 }
 
 
-// Find the maximum degree amongst nodes of the graph
+// Set the degree of every vertex and return the maximum degree of the graph
 template <class vertex>
 uintT setDegrees(const graph<vertex> &GA, Color* &colorData)
 {
-    uintT maxDegree = 0;
-    for (uintT v_i=0; v_i < GA.n; v_i++)
+    parallel_for (0, GA.n, [&] (uintT v_i)
     {
         colorData[v_i].degree = GA.V[v_i].getOutDegree();
-        if (colorData[v_i].degree > maxDegree)
-        {
-            maxDegree = colorData[v_i].degree;
-        }
-    }
-    return maxDegree;
+    });
+    return getMaxDeg(GA);
 }
 
 
@@ -348,23 +349,3 @@ void randomizeColors(graph<vertex> &GA, Color* &colorData)
         colorData[v_i] = dist(mt);
     }
 }
-
-
-
-
-//Check graph is undirected
-template <class vertex>
-void ensureUndirected(graph<vertex> &GA)
-{
-    for(uintT v_i = 0; v_i < GA.n; v_i++)
-    { 
-        const uintT outVDegree = GA.V[v_i].getOutDegree();
-        const uintT inVDegree = GA.V[v_i].getInDegree();
-
-        if (outVDegree != inVDegree)
-        {
-            cout << "Graph is not undirected. Exiting..." << endl;
-            exit(2);
-        }
-    }
-}
\ No newline at end of file
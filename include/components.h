@@ -0,0 +1,286 @@
+#ifndef __COMPONENTS_H__
+#define __COMPONENTS_H__
+
+#include "coloring_base.h"
+
+// Label propagation step: every vertex takes the smallest label among its
+// own and its neighbours'. A vertex joins the next frontier the first time
+// its label drops in a round.
+struct CC_Propagate
+{
+    uintE* labels;
+    uintE* prevLabels;
+    CC_Propagate(uintE* _labels, uintE* _prevLabels) : labels(_labels), prevLabels(_prevLabels) { }
+
+    inline bool update(uintE s, uintE d)
+    {
+        uintE oldLabel = labels[d];
+        if (labels[s] < oldLabel)
+        {
+            labels[d] = labels[s];
+            return oldLabel == prevLabels[d];
+        }
+        return false;
+    }
+
+    inline bool updateAtomic(uintE s, uintE d)
+    {
+        uintE oldLabel = labels[d];
+        return writeMin(&labels[d], labels[s]) && oldLabel == prevLabels[d];
+    }
+
+    inline bool cond(uintE d)
+    {
+        return true;
+    }
+};
+
+// Points the in- and out-edges of v at one neighbour list, the graph
+// being undirected
+template <class vertex, class E>
+inline void setUndirectedNeighbors(vertex &v, E* neighbors, uintT degree)
+{
+    v.setOutNeighbors(neighbors);
+    v.setInNeighbors(neighbors);
+    v.setOutDegree(degree);
+    v.setInDegree(degree);
+}
+
+// Compressed neighbour lists cannot be rebuilt this way
+template <class E>
+inline void setUndirectedNeighbors(compressedSymmetricVertex &v, E* neighbors, uintT degree)
+{
+    cout << "Subgraphs of compressed graphs are not supported. Exiting..." << endl;
+    exit(2);
+}
+
+template <class E>
+inline void setUndirectedNeighbors(compressedAsymmetricVertex &v, E* neighbors, uintT degree)
+{
+    cout << "Subgraphs of compressed graphs are not supported. Exiting..." << endl;
+    exit(2);
+}
+
+// Connected components of an undirected graph, with the vertices of each
+// component stored contiguously. Inputs made of one giant component and
+// a forest of small ones can then color the small components directly,
+// one sequential first-fit per component, and run an engine only on the
+// giant component, extracted as a graph of its own.
+template <class vertex>
+class ComponentDecomposition
+{
+public:
+    // Components are found by parallel label propagation of the smallest
+    // vertex id, then grouped by a parallel counting sort on their number
+    ComponentDecomposition(graph<vertex> &GA) : GA(GA), numVertices(GA.n)
+    {
+        uintE* labels = newA(uintE, numVertices);
+        uintE* prevLabels = newA(uintE, numVertices);
+        bool* all = newA(bool, numVertices);
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            labels[v_i] = v_i;
+            all[v_i] = true;
+        });
+        vertexSubset frontier(numVertices, all);
+        rounds = 0;
+        while (!frontier.isEmpty())
+        {
+            rounds++;
+            vertexMap(frontier, [&] (uintE v_i)
+            {
+                prevLabels[v_i] = labels[v_i];
+            });
+            vertexSubset next = edgeMap(GA, frontier, CC_Propagate(labels, prevLabels));
+            frontier.del();
+            frontier = next;
+        }
+        frontier.del();
+
+        // Number the components by their root, the vertex whose id is the label
+        componentOf = newA(uintE, numVertices);
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            componentOf[v_i] = (labels[v_i] == v_i);
+        });
+        components = sequence::plusScan(componentOf, componentOf, (uintE) numVertices);
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            prevLabels[v_i] = componentOf[labels[v_i]];
+        });
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            componentOf[v_i] = prevLabels[v_i];
+        });
+        free(labels);
+        free(prevLabels);
+
+        offsets = newA(uintT, components + 1);
+        members = newA(uintE, numVertices);
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            members[v_i] = v_i;
+        });
+        if (numVertices > 0)
+        {
+            intSort::iSort(members, offsets, numVertices, components,
+                [&] (uintE v_i) { return componentOf[v_i]; });
+        }
+        offsets[components] = numVertices;
+
+        giantComponent = 0;
+        if (components > 0)
+        {
+            giantComponent = sequence::reduce<uintT>((long) 0, (long) components,
+                [&] (uintT a, uintT b) { return size(a) >= size(b) ? a : b; },
+                [&] (long c_i) { return (uintT) c_i; });
+        }
+    }
+
+    ~ComponentDecomposition()
+    {
+        free(componentOf);
+        free(offsets);
+        free(members);
+    }
+
+    uintT numComponents() const
+    {
+        return components;
+    }
+
+    // Rounds of label propagation needed
+    uintT propagationRounds() const
+    {
+        return rounds;
+    }
+
+    uintT component(uintT v_i) const
+    {
+        return componentOf[v_i];
+    }
+
+    size_t size(uintT c_i) const
+    {
+        return offsets[c_i + 1] - offsets[c_i];
+    }
+
+    const uintE* vertices(uintT c_i) const
+    {
+        return members + offsets[c_i];
+    }
+
+    // The largest component
+    uintT giant() const
+    {
+        return giantComponent;
+    }
+
+    // First-fit coloring of every component but the giant one. The
+    // components are batched by size into edge-balanced blocks, and every
+    // component is colored sequentially by the worker of its block.
+    // Returns the number of vertices colored.
+    size_t colorSmallComponents(colorVector &colorData, WorkerForbiddenColors &workerColors) const
+    {
+        edgeBalancedBlocks batches(components, [&] (long c_i)
+        {
+            return c_i == giantComponent ? (size_t) 1 : size(c_i);
+        });
+        batches.run([&] (uintT c_i)
+        {
+            if (c_i == giantComponent)
+                return;
+            ForbiddenColors &forbiddenColors = workerColors.local();
+            const uintE* cVertices = vertices(c_i);
+            for (size_t m_i = 0; m_i < size(c_i); m_i++)
+            {
+                const uintE v_i = cVertices[m_i];
+                forbiddenColors.reset(GA.V[v_i].getOutDegree());
+                markNeighborColors(GA.V[v_i], colorData, forbiddenColors);
+                colorData[v_i] = forbiddenColors.firstFree();
+            }
+        });
+        batches.del();
+        return numVertices - (components > 0 ? size(giantComponent) : 0);
+    }
+
+    // The giant component as a graph of its own. Vertex j of the result is
+    // vertices(giant())[j]. Its neighbour lists are copies, so it has to
+    // be freed with del().
+    graph<vertex> giantSubgraph() const
+    {
+        const uintE* gVertices = vertices(giantComponent);
+        const size_t gSize = (components > 0) ? size(giantComponent) : 0;
+
+        // Position of every giant vertex in gVertices
+        uintE* localId = newA(uintE, numVertices);
+        parallel_for (0, gSize, [&] (size_t g_i)
+        {
+            localId[gVertices[g_i]] = g_i;
+        });
+
+        uintT* edgeOffsets = newA(uintT, gSize + 1);
+        parallel_for (0, gSize, [&] (size_t g_i)
+        {
+            edgeOffsets[g_i] = GA.V[gVertices[g_i]].getOutDegree();
+        });
+        const uintT gEdges = sequence::plusScan(edgeOffsets, edgeOffsets, (uintT) gSize);
+        edgeOffsets[gSize] = gEdges;
+
+#ifndef WEIGHTED
+        uintE* edges = newA(uintE, gEdges);
+#else
+        intE* edges = newA(intE, 2 * (size_t) gEdges);
+#endif
+        vertex* V = newA(vertex, gSize);
+        parallel_for (0, gSize, [&] (size_t g_i)
+        {
+            const vertex &v = GA.V[gVertices[g_i]];
+            const uintT vDegree = v.getOutDegree();
+            for (uintT n_i = 0; n_i < vDegree; n_i++)
+            {
+#ifndef WEIGHTED
+                edges[edgeOffsets[g_i] + n_i] = localId[v.getOutNeighbor(n_i)];
+#else
+                edges[2 * (edgeOffsets[g_i] + n_i)] = localId[v.getOutNeighbor(n_i)];
+                edges[2 * (edgeOffsets[g_i] + n_i) + 1] = v.getOutWeight(n_i);
+#endif
+            }
+#ifndef WEIGHTED
+            setUndirectedNeighbors(V[g_i], edges + edgeOffsets[g_i], vDegree);
+#else
+            setUndirectedNeighbors(V[g_i], edges + 2 * edgeOffsets[g_i], vDegree);
+#endif
+        });
+        free(localId);
+        free(edgeOffsets);
+
+        Uncompressed_Mem<vertex>* mem = new Uncompressed_Mem<vertex>(V, gSize, gEdges, edges);
+        return graph<vertex>(V, gSize, gEdges, mem);
+    }
+
+    // Copy the colors of the giant subgraph back into colorData
+    void stitchGiant(const colorVector &giantColors, colorVector &colorData) const
+    {
+        const uintE* gVertices = vertices(giantComponent);
+        parallel_for (0, giantColors.size(), [&] (size_t g_i)
+        {
+            colorData[gVertices[g_i]] = giantColors[g_i];
+        });
+    }
+
+private:
+    ComponentDecomposition(const ComponentDecomposition&);
+    ComponentDecomposition& operator=(const ComponentDecomposition&);
+
+    graph<vertex> &GA;
+    size_t numVertices;
+    uintT rounds;
+    uintT components;
+    uintT giantComponent;
+    uintE* componentOf;
+    uintT* offsets;
+    uintE* members;
+};
+
+#endif
@@ -9,6 +9,10 @@
 #include <stdint.h>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
+
+#include "parallel.h"
+#include "numaPlacement.h"
 
 //#include "../utils/utils.h"
 
@@ -34,14 +38,15 @@ class DenseBitset {
             len = n;
             arrlen = n / (8 * sizeof(IdType)) + 1;
             array = (IdType*) realloc(array, sizeof(IdType) * arrlen);
+            numaPlaceVertexArray(array, arrlen, sizeof(IdType));
         }
 
         void clear() {
-            memset(array, 0, arrlen * sizeof(IdType));
+            fill(0);
         }
 
         void setAll() {
-            memset(array, 0xff, arrlen * sizeof(IdType));
+            fill(0xff);
         }
 
         inline bool get(IdType b) const {
@@ -130,6 +135,18 @@ class DenseBitset {
         }
 
     private:
+        // Blocks are written by different workers so that the pages are
+        // first touched where the matching vertices are processed
+        void fill(int value) {
+            const IdType blockWords = 1 << 14;
+            const IdType numBlocks = (arrlen + blockWords - 1) / blockWords;
+            parallel_for (0, numBlocks, [&] (IdType b_i) {
+                IdType start = b_i * blockWords;
+                IdType words = std::min(blockWords, arrlen - start);
+                memset(array + start, value, words * sizeof(IdType));
+            });
+        }
+
         inline static void bitToPos(IdType b, IdType &arrpos, IdType &bitpos) {
             arrpos = b / (8 * (int) sizeof(IdType));
             bitpos = b & (8 * (int) sizeof(IdType) - 1);
@@ -0,0 +1,116 @@
+#ifndef __EASY_GRAPHS_H__
+#define __EASY_GRAPHS_H__
+
+#include "coloring_base.h"
+#include "components.h"
+
+// BFS step of the 2-coloring: a vertex reached first takes the other
+// color than the vertex it was reached from
+struct BFS_Parity
+{
+    uintT* colors;
+    BFS_Parity(uintT* _colors) : colors(_colors) { }
+
+    inline bool update(uintE s, uintE d)
+    {
+        if (colors[d] != UINT_T_MAX)
+            return false;
+        colors[d] = 1 - colors[s];
+        return true;
+    }
+
+    inline bool updateAtomic(uintE s, uintE d)
+    {
+        return CAS(&colors[d], UINT_T_MAX, 1 - colors[s]);
+    }
+
+    inline bool cond(uintE d)
+    {
+        return colors[d] == UINT_T_MAX;
+    }
+};
+
+// Fast paths for structurally easy graphs (-fast-paths). Every component
+// is 2-colored by a parallel BFS from its smallest vertex, all components
+// at once. The graph is bipartite (forests included) if no edge joins two
+// vertices of the same color. Otherwise, if no vertex has more than two
+// neighbours, every component is a path or a cycle, and only an odd cycle
+// can have a conflict: its two BFS waves meet on exactly one edge, whose
+// endpoint of higher id takes color 2. Either way the coloring is optimal
+// and takes linear time.
+//
+// Returns true and sets colorData if a fast path applied. Otherwise
+// colorData is untouched and the caller runs its general engine.
+template <class vertex>
+bool colorEasyGraph(graph<vertex> &GA, colorVector &colorData, const uintT maxDegree, bool verbose)
+{
+    timer easyTimer;
+    easyTimer.start();
+    const size_t numVertices = GA.n;
+
+    ComponentDecomposition<vertex> components(GA);
+    const uintT numComponents = components.numComponents();
+    const bool forest = ((size_t) GA.m == 2 * (numVertices - numComponents));
+
+    colorVector parity = makeColorVector(numVertices, UINT_T_MAX);
+    uintE* roots = newA(uintE, numComponents);
+    parallel_for (0, numComponents, [&] (uintT c_i)
+    {
+        roots[c_i] = components.vertices(c_i)[0];
+        parity[roots[c_i]] = 0;
+    });
+    vertexSubset frontier(numVertices, numComponents, roots);
+    while (!frontier.isEmpty())
+    {
+        vertexSubset next = edgeMap(GA, frontier, BFS_Parity(parity.data()));
+        frontier.del();
+        frontier = next;
+    }
+    frontier.del();
+
+    // Endpoints of higher id of the edges joining equal colors
+    bool* conflicted = newA(bool, numVertices);
+    edgeBalancedFor(GA, [&] (uintT v_i)
+    {
+        bool conflict = false;
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        for (uintT n_i = 0; n_i < vDegree && !conflict; n_i++)
+        {
+            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+            conflict = (neigh < v_i && parity[neigh] == parity[v_i]);
+        }
+        conflicted[v_i] = conflict;
+    });
+    const size_t conflicts = sequence::sum(conflicted, numVertices);
+
+    const char* structure = NULL;
+    if (conflicts == 0)
+        structure = forest ? "forest" : "bipartite";
+    else if (maxDegree <= 2)
+    {
+        structure = "paths and cycles";
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            if (conflicted[v_i])
+                parity[v_i] = 2;
+        });
+    }
+    free(conflicted);
+
+    if (verbose)
+    {
+        std::cout << "Fast path: " << (structure ? structure : "none") << std::endl;
+        std::cout << "\tComponents: " << numComponents << std::endl;
+        std::cout << "\tTime: " << setprecision(TIME_PRECISION) << easyTimer.stop() << std::endl;
+    }
+    if (structure == NULL)
+        return false;
+
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        colorData[v_i] = parity[v_i];
+    });
+    return true;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef __FORBIDDEN_COLORS_H__
+#define __FORBIDDEN_COLORS_H__
+
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "parallel.h"
+
+// Colors taken by the neighbours of a vertex, one bit per color in 64-bit
+// words. The smallest free color is found a SIMD register of words at a
+// time (512 colors with AVX-512, 256 with AVX2, 64 otherwise), the
+// instruction set being chosen at compile time (-march=native, or make
+// NATIVE=1).
+class ForbiddenColors
+{
+public:
+#if defined(__AVX512F__)
+    static const uintT groupWords = 8;
+#elif defined(__AVX2__)
+    static const uintT groupWords = 4;
+#else
+    static const uintT groupWords = 1;
+#endif
+
+    ForbiddenColors() : words(NULL), numWords(0), limit(0) { }
+
+    ForbiddenColors(uintT maxLimit) : words(NULL), numWords(0), limit(0)
+    {
+        resize(maxLimit);
+    }
+
+    ~ForbiddenColors()
+    {
+        free(words);
+    }
+
+    // Allow limits up to maxLimit
+    void resize(uintT maxLimit)
+    {
+        free(words);
+        numWords = (maxLimit / 64 + 1 + groupWords - 1) / groupWords * groupWords;
+        if (posix_memalign((void**) &words, 64, numWords * sizeof(uint64_t)) != 0)
+            abort();
+        memset(words, 0, numWords * sizeof(uint64_t));
+        limit = 0;
+    }
+
+    // Start a new vertex, only colors in [0, newLimit] are tracked
+    inline void reset(uintT newLimit)
+    {
+        limit = newLimit;
+        const uintT usedWords = (limit / 64 + groupWords) / groupWords * groupWords;
+        memset(words, 0, usedWords * sizeof(uint64_t));
+    }
+
+    inline void mark(uintT color)
+    {
+        if (color <= limit)
+            words[color >> 6] |= uint64_t(1) << (color & 63);
+    }
+
+    inline bool isForbidden(uintT color) const
+    {
+        return color <= limit && (words[color >> 6] >> (color & 63)) & 1;
+    }
+
+    // Smallest color in [0, limit] no neighbour has, or limit + 1 if all
+    // are taken
+    inline uintT firstFree() const
+    {
+        const uintT lastWord = limit / 64;
+#if defined(__AVX512F__)
+        const __m512i full = _mm512_set1_epi64(-1);
+        for (uintT w_i = 0; w_i <= lastWord; w_i += groupWords)
+        {
+            __mmask8 open = _mm512_cmpneq_epi64_mask(_mm512_load_si512(words + w_i), full);
+            if (open)
+                return firstFreeIn(w_i + __builtin_ctz(open));
+        }
+#elif defined(__AVX2__)
+        const __m256i full = _mm256_set1_epi64x(-1);
+        for (uintT w_i = 0; w_i <= lastWord; w_i += groupWords)
+        {
+            __m256i group = _mm256_load_si256((const __m256i*) (words + w_i));
+            int fullMask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(group, full)));
+            if (fullMask != 0xF)
+                return firstFreeIn(w_i + __builtin_ctz(~fullMask));
+        }
+#else
+        for (uintT w_i = 0; w_i <= lastWord; w_i++)
+        {
+            if (~words[w_i])
+                return firstFreeIn(w_i);
+        }
+#endif
+        return limit + 1;
+    }
+
+private:
+    ForbiddenColors(const ForbiddenColors&);
+    ForbiddenColors& operator=(const ForbiddenColors&);
+
+    inline uintT firstFreeIn(uintT w_i) const
+    {
+        uintT color = w_i * 64 + __builtin_ctzll(~words[w_i]);
+        return std::min(color, limit + 1);
+    }
+
+    uint64_t* words;
+    uintT numWords;
+    uintT limit;
+};
+
+
+// One ForbiddenColors per worker so that the loop bodies of a parallel_for
+// do not allocate. Has to be created after the worker count is set.
+class WorkerForbiddenColors
+{
+public:
+    WorkerForbiddenColors(uintT maxLimit) : sets(getWorkers())
+    {
+        for (size_t s_i = 0; s_i < sets.size(); s_i++)
+            sets[s_i].resize(maxLimit);
+    }
+
+    inline ForbiddenColors& local()
+    {
+        return sets[getWorkerNum()];
+    }
+
+private:
+    std::vector<ForbiddenColors> sets;
+};
+
+#endif
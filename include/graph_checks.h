@@ -0,0 +1,244 @@
+#ifndef __GRAPH_CHECKS_H__
+#define __GRAPH_CHECKS_H__
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ligra.h"
+
+
+// Find the maximum degree amongst nodes of the graph
+template <class vertex>
+uintT getMaxDeg(const graph<vertex> &GA)
+{
+    return sequence::reduce<uintT>((long) 0, GA.n, maxF<uintT>(),
+        [&] (long v_i) { return GA.V[v_i].getOutDegree(); });
+}
+
+
+// Count the vertices whose out degree differs from their in degree
+template <class vertex>
+long countDegreeMismatches(const graph<vertex> &GA)
+{
+    return sequence::reduce<long>((long) 0, GA.n, addF<long>(),
+        [&] (long v_i) -> long
+        {
+            return GA.V[v_i].getOutDegree() != GA.V[v_i].getInDegree();
+        });
+}
+
+
+// Check that every edge (u, v) has its reverse (v, u). Each lookup is a
+// binary search in the neighbour's adjacency list, so unsorted lists are
+// first copied and sorted.
+template <class vertex>
+bool verifySymmetric(const graph<vertex> &GA)
+{
+    const long numVertices = GA.n;
+    bool sorted = sequence::reduce<bool>((long) 0, numVertices,
+        [] (bool a, bool b) { return a && b; },
+        [&] (long v_i)
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            for (uintT n_i = 1; n_i < vDegree; n_i++)
+            {
+                if (GA.V[v_i].getOutNeighbor(n_i - 1) > GA.V[v_i].getOutNeighbor(n_i))
+                    return false;
+            }
+            return true;
+        });
+
+    // Sorted copy of the adjacency lists, only built when needed
+    uintT* offsets = NULL;
+    uintE* edges = NULL;
+    if (!sorted)
+    {
+        offsets = newA(uintT, numVertices + 1);
+        parallel_for (0, numVertices, [&] (long v_i)
+        {
+            offsets[v_i] = GA.V[v_i].getOutDegree();
+        });
+        offsets[numVertices] = sequence::plusScan(offsets, offsets, numVertices);
+        edges = newA(uintE, offsets[numVertices]);
+        parallel_for (0, numVertices, [&] (long v_i)
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            for (uintT n_i = 0; n_i < vDegree; n_i++)
+                edges[offsets[v_i] + n_i] = GA.V[v_i].getOutNeighbor(n_i);
+            std::sort(edges + offsets[v_i], edges + offsets[v_i] + vDegree);
+        });
+    }
+
+    auto lt = [] (const uintE &l, const uintE &r) { return l < r; };
+    long missing = sequence::reduce<long>((long) 0, numVertices, addF<long>(),
+        [&] (long v_i) -> long
+        {
+            long vMissing = 0;
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            for (uintT n_i = 0; n_i < vDegree; n_i++)
+            {
+                uintE neigh = GA.V[v_i].getOutNeighbor(n_i);
+                const uintT nDegree = GA.V[neigh].getOutDegree();
+                size_t pos;
+                uintE found;
+                if (sorted)
+                {
+                    auto neighList = make_in_imap<uintE>(nDegree,
+                        [&] (size_t j) { return (uintE) GA.V[neigh].getOutNeighbor(j); });
+                    pos = pbbs::binary_search(neighList, (uintE) v_i, lt);
+                    found = (pos < nDegree) ? neighList[pos] : UINT_E_MAX;
+                }
+                else
+                {
+                    uintE* neighList = edges + offsets[neigh];
+                    pos = std::lower_bound(neighList, neighList + nDegree, (uintE) v_i) - neighList;
+                    found = (pos < nDegree) ? neighList[pos] : UINT_E_MAX;
+                }
+                if (found != (uintE) v_i)
+                    vMissing++;
+            }
+            return vMissing;
+        });
+
+    if (!sorted)
+    {
+        free(offsets);
+        free(edges);
+    }
+
+    if (missing != 0)
+        cout << "Symmetry check: " << missing << " edges have no reverse edge" << endl;
+    return missing == 0;
+}
+
+
+// The result of -verify-symmetry can be cached (-cache-symmetry) in a
+// .symcheck file next to the input graph. The input files are never
+// modified. A cached result is only trusted when the vertex and edge counts
+// and the size and modification time of every input file still match.
+inline std::vector<std::string> graphInputFiles(commandLine &P)
+{
+    std::string iFile = P.getArgument(0);
+    std::vector<std::string> files;
+    if (P.getOption("-b"))
+    {
+        files.push_back(iFile + ".config");
+        files.push_back(iFile + ".adj");
+        files.push_back(iFile + ".idx");
+    }
+    else
+        files.push_back(iFile);
+    return files;
+}
+
+// One "n m size mtime ..." line describing the loaded graph and its files,
+// empty when an input file cannot be inspected
+template <class vertex>
+std::string graphFingerprint(const graph<vertex> &GA, commandLine &P)
+{
+    std::stringstream ss;
+    ss << GA.n << " " << GA.m;
+    std::vector<std::string> files = graphInputFiles(P);
+    for (size_t f_i = 0; f_i < files.size(); f_i++)
+    {
+        struct stat fileStat;
+        if (stat(files[f_i].c_str(), &fileStat) != 0)
+            return "";
+        ss << " " << (long) fileStat.st_size << " " << (long) fileStat.st_mtime;
+    }
+    return ss.str();
+}
+
+inline std::string symmetryCacheFile(commandLine &P)
+{
+    return std::string(P.getArgument(0)) + ".symcheck";
+}
+
+// Returns -1 when no valid cached value exists
+inline long readSymmetryCache(commandLine &P, const std::string &fingerprint)
+{
+    ifstream in(symmetryCacheFile(P).c_str());
+    std::string cachedFingerprint;
+    long value;
+    if (!getline(in, cachedFingerprint) || cachedFingerprint != fingerprint || !(in >> value))
+        return -1;
+    return (value == 0 || value == 1) ? value : -1;
+}
+
+// Written to a temporary file and renamed into place, so a concurrent or
+// interrupted run never leaves a partial cache behind
+inline void writeSymmetryCache(commandLine &P, const std::string &fingerprint, bool symmetric)
+{
+    const std::string cacheFile = symmetryCacheFile(P);
+    std::stringstream tmpName;
+    tmpName << cacheFile << ".tmp" << getpid();
+    const std::string tmpFile = tmpName.str();
+    {
+        ofstream out(tmpFile.c_str(), ios::trunc);
+        if (!out.is_open())
+        {
+            cout << "Unable to write symmetry cache: " << cacheFile << endl;
+            return;
+        }
+        out << fingerprint << "\n" << (symmetric ? 1 : 0) << "\n";
+        if (!out.good())
+        {
+            out.close();
+            remove(tmpFile.c_str());
+            return;
+        }
+    }
+    if (rename(tmpFile.c_str(), cacheFile.c_str()) != 0)
+    {
+        cout << "Unable to write symmetry cache: " << cacheFile << endl;
+        remove(tmpFile.c_str());
+    }
+}
+
+
+//Check graph is undirected
+template <class vertex>
+void ensureUndirected(graph<vertex> &GA)
+{
+    if (countDegreeMismatches(GA) != 0)
+    {
+        cout << "Graph is not undirected. Exiting..." << endl;
+        exit(2);
+    }
+}
+
+// As above, and with -verify-symmetry also check that every edge has its
+// reverse. With -cache-symmetry the result of the full check is kept in a
+// .symcheck file next to the graph.
+template <class vertex>
+void ensureUndirected(graph<vertex> &GA, commandLine &P)
+{
+    ensureUndirected(GA);
+    if (!P.getOption("-verify-symmetry"))
+        return;
+
+    const bool useCache = P.getOption("-cache-symmetry");
+    const std::string fingerprint = useCache ? graphFingerprint(GA, P) : "";
+    long cached = fingerprint.empty() ? -1 : readSymmetryCache(P, fingerprint);
+    bool symmetric = (cached == 1);
+    if (cached == -1)
+    {
+        symmetric = verifySymmetric(GA);
+        if (!fingerprint.empty())
+            writeSymmetryCache(P, fingerprint, symmetric);
+    }
+    if (!symmetric)
+    {
+        cout << "Graph is not undirected. Exiting..." << endl;
+        exit(2);
+    }
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __HUB_COLORS_H__
+#define __HUB_COLORS_H__
+
+#include <stdint.h>
+#include <cstdlib>
+#include <algorithm>
+
+#include "ligra.h"
+#include "forbidden_colors.h"
+#include "neighbor_colors.h"
+
+// Degree from which a vertex is colored with nested parallelism (-hub-degree)
+#define HUB_DEGREE_DEFAULT (1 << 15)
+
+// Neighbours per task of the parallel neighbour scan
+#define HUB_SCAN_GRANULARITY 4096
+
+// First-fit search for a single vertex of very high degree, in the spirit
+// of the parallel flag of decodeInNghBreakEarly. Balanced loops still give
+// a hub to one worker, so its neighbours are scanned in parallel into one
+// shared bitmap with atomic OR, and the first zero bit is then found by a
+// parallel min-reduction over the words. Returns the smallest color in
+// [0, limit] no neighbour has, or limit + 1 if all are taken, like
+// ForbiddenColors::firstFree.
+template <class vertex, class Colors>
+uintT hubFirstFree(const vertex &v, const Colors &colorData, uintT limit)
+{
+    const uintT vDegree = v.getOutDegree();
+    const size_t numWords = limit / 64 + 1;
+    uint64_t* words = newA(uint64_t, numWords);
+    parallel_for (0, numWords, [&] (size_t w_i)
+    {
+        words[w_i] = 0;
+    });
+
+    parallel_for (0, vDegree, [&] (uintT n_i)
+    {
+        const uintT color = colorData[v.getOutNeighbor(n_i)];
+        if (color <= limit)
+        {
+            // Most colors of a hub's neighbours repeat, so the locked
+            // instruction is skipped for bits already set
+            const uint64_t bit = uint64_t(1) << (color & 63);
+            if (!(words[color >> 6] & bit))
+                __sync_fetch_and_or(words + (color >> 6), bit);
+        }
+    }, HUB_SCAN_GRANULARITY);
+
+    const uintT color = sequence::reduce<uintT>((long) 0, (long) numWords, minF<uintT>(),
+        [&] (long w_i)
+        {
+            return ~words[w_i] ? (uintT) (w_i * 64 + __builtin_ctzll(~words[w_i])) : UINT_T_MAX;
+        });
+    free(words);
+    return std::min(color, limit + 1);
+}
+
+// Smallest color in [0, limit] no neighbour of v has, or limit + 1.
+// Vertices with at least hubDegree neighbours take the parallel path,
+// all others the worker's own forbiddenColors.
+template <class vertex, class Colors>
+inline uintT firstFitColor(const vertex &v, const Colors &colorData, ForbiddenColors &forbiddenColors,
+                           uintT limit, uintT hubDegree)
+{
+    if (v.getOutDegree() >= hubDegree)
+        return hubFirstFree(v, colorData, limit);
+
+    forbiddenColors.reset(limit);
+    markNeighborColors(v, colorData, forbiddenColors);
+    return forbiddenColors.firstFree();
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef __JONES_PLASSMANN_H__
+#define __JONES_PLASSMANN_H__
+
+#include "coloring_base.h"
+
+// Fixed priority of a vertex: a hash of its id, ties broken by the id
+inline bool higherPriority(uintE u, uintE v)
+{
+    uintE hu = hashInt(u), hv = hashInt(v);
+    return hu > hv || (hu == hv && u > v);
+}
+
+// Releases the neighbours of a colored vertex that have lower priority.
+// A vertex joins the next frontier when its last higher priority
+// neighbour is colored.
+struct JP_Release
+{
+    uintT* waitCount;
+    JP_Release(uintT* _waitCount) : waitCount(_waitCount) { }
+
+    inline bool update(uintE s, uintE d)
+    {
+        if (!higherPriority(s, d))
+            return false;
+        return --waitCount[d] == 0;
+    }
+
+    inline bool updateAtomic(uintE s, uintE d)
+    {
+        if (!higherPriority(s, d))
+            return false;
+        return __sync_sub_and_fetch(&waitCount[d], 1) == 0;
+    }
+
+    inline bool cond(uintE d)
+    {
+        return waitCount[d] > 0;
+    }
+};
+
+// Jones-Plassmann coloring with hash priorities. Every vertex gets the
+// smallest color not used by its higher priority neighbours, which are
+// all colored before it, so the result is the greedy coloring in priority
+// order whatever the number of workers or the schedule. Returns the
+// number of rounds. Vertices of degree hubDegree or more are colored with
+// nested parallelism.
+template <class vertex>
+uintT colorJonesPlassmann(graph<vertex> &GA, colorVector &colorData, const uintT maxDegree, bool verbose,
+                          uintT hubDegree = HUB_DEGREE_DEFAULT)
+{
+    timer iterTimer;
+    const size_t numVertices = GA.n;
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        colorData[v_i] = UINT_T_MAX;
+    });
+
+    // Count the higher priority neighbours of every vertex, the ones without
+    // any form the first frontier
+    uintT* waitCount = newA(uintT, numVertices);
+    bool* roots = newA(bool, numVertices);
+    edgeBalancedFor(GA, [&] (uintT v_i)
+    {
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        uintT higher = 0;
+        for (uintT n_i = 0; n_i < vDegree; n_i++)
+        {
+            if (higherPriority(GA.V[v_i].getOutNeighbor(n_i), v_i))
+                higher++;
+        }
+        waitCount[v_i] = higher;
+        roots[v_i] = (higher == 0);
+    });
+    vertexSubset frontier(numVertices, roots);
+
+    double lastStopTime = iterTimer.getTime();
+    uintT round = 0;
+    while (!frontier.isEmpty())
+    {
+        round++;
+        const long activeVertices = frontier.numNonzeros();
+
+        // Frontier vertices are never adjacent, and uncolored neighbours
+        // (UINT_T_MAX) are ignored by mark. Hubs may meet in one frontier,
+        // so its vertices are split by edges rather than by count
+        edgeBalancedFor(GA, frontier, [&] (uintE v_i)
+        {
+            colorData[v_i] = firstFitColor(GA.V[v_i], colorData, workerColors.local(),
+                                           GA.V[v_i].getOutDegree(), hubDegree);
+        });
+
+        vertexSubset next = edgeMap(GA, frontier, JP_Release(waitCount));
+        frontier.del();
+        frontier = next;
+
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << round << std::endl;
+            std::cout << "\tActive Vs: " << activeVertices << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+    }
+    frontier.del();
+    free(waitCount);
+    return round;
+}
+
+#endif
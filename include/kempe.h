@@ -0,0 +1,308 @@
+#ifndef __KEMPE_H__
+#define __KEMPE_H__
+
+#include <atomic>
+#include <vector>
+
+#include "coloring_base.h"
+
+// Color class elimination by Kempe chain interchanges. A vertex v of the
+// class being eliminated first tries any color no neighbour has. Failing
+// that, for a pair of colors (a, b) the (a, b) Kempe chains through the
+// neighbours of v colored a are found by a bounded BFS. If none of them
+// reaches a neighbour of v colored b, swapping a and b along them frees a
+// for v.
+//
+// Vertices of a class are tried in parallel. Every attempt claims the
+// closed neighbourhood of v and of every chain vertex with a CAS on a
+// per-vertex claim flag, so two attempts whose chains overlap or touch
+// cannot both succeed. An attempt that loses a claim releases everything
+// and is retried in the next round.
+template <class vertex>
+class KempeEliminator
+{
+public:
+    enum Outcome { Moved, Blocked, Stuck };
+
+    KempeEliminator(graph<vertex> &GA, colorVector &colorData, uintT maxChain) :
+        GA(GA), colorData(colorData), maxChain(maxChain), nextStamp(1)
+    {
+        const size_t numVertices = GA.n;
+        claims = newA(uintT, numVertices);
+        chainStamp = newA(uint64_t, numVertices);
+        nearStamp = newA(uint64_t, numVertices);
+        parallel_for (0, numVertices, [&] (size_t v_i)
+        {
+            claims[v_i] = UINT_T_MAX;
+            chainStamp[v_i] = 0;
+            nearStamp[v_i] = 0;
+        });
+    }
+
+    ~KempeEliminator()
+    {
+        free(claims);
+        free(chainStamp);
+        free(nearStamp);
+    }
+
+    // Recolor v_i away from its color using the colors [0, numColors) not
+    // marked in removed
+    Outcome recolor(uintT v_i, const bool* removed, uintT numColors)
+    {
+        const uintT target = colorData[v_i];
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        const uint64_t stamp = nextStamp.fetch_add(1);
+        std::vector<uintT> claimed;
+
+        if (!claimClosed(v_i, v_i, claimed))
+            return release(claimed, 0, Blocked);
+        std::vector<char> used(numColors, 0);
+        for (uintT n_i = 0; n_i < vDegree; n_i++)
+        {
+            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+            nearStamp[neigh] = stamp;
+            if (colorData[neigh] < numColors)
+                used[colorData[neigh]] = 1;
+        }
+        for (uintT color = 0; color < numColors; color++)
+        {
+            if (color != target && !removed[color] && !used[color])
+            {
+                colorData[v_i] = color;
+                return release(claimed, 0, Moved);
+            }
+        }
+
+        const size_t ownClaims = claimed.size();
+        std::vector<uintT> chain;
+        for (uintT a = 0; a < numColors; a++)
+        {
+            if (a == target || removed[a])
+                continue;
+            for (uintT b = 0; b < numColors; b++)
+            {
+                if (b == target || b == a || removed[b])
+                    continue;
+                const uint64_t chainId = nextStamp.fetch_add(1);
+                Outcome outcome = findChains(v_i, a, b, stamp, chainId, claimed, chain);
+                if (outcome == Moved)
+                {
+                    for (size_t c_i = 0; c_i < chain.size(); c_i++)
+                        colorData[chain[c_i]] = (colorData[chain[c_i]] == a) ? b : a;
+                    colorData[v_i] = a;
+                    return release(claimed, 0, Moved);
+                }
+                if (outcome == Blocked)
+                    return release(claimed, 0, Blocked);
+                release(claimed, ownClaims, Stuck);
+            }
+        }
+        return release(claimed, 0, Stuck);
+    }
+
+private:
+    KempeEliminator(const KempeEliminator&);
+    KempeEliminator& operator=(const KempeEliminator&);
+
+    inline bool claim(uintT u_i, uintT owner, std::vector<uintT> &claimed)
+    {
+        if (claims[u_i] == owner)
+            return true;
+        if (!CAS(&claims[u_i], UINT_T_MAX, owner))
+            return false;
+        claimed.push_back(u_i);
+        return true;
+    }
+
+    // Claim u_i and all its neighbours
+    bool claimClosed(uintT u_i, uintT owner, std::vector<uintT> &claimed)
+    {
+        if (!claim(u_i, owner, claimed))
+            return false;
+        const uintT uDegree = GA.V[u_i].getOutDegree();
+        for (uintT n_i = 0; n_i < uDegree; n_i++)
+        {
+            if (!claim(GA.V[u_i].getOutNeighbor(n_i), owner, claimed))
+                return false;
+        }
+        return true;
+    }
+
+    // Drop the claims after the first keep ones
+    Outcome release(std::vector<uintT> &claimed, size_t keep, Outcome outcome)
+    {
+        for (size_t c_i = keep; c_i < claimed.size(); c_i++)
+            claims[claimed[c_i]] = UINT_T_MAX;
+        claimed.resize(keep);
+        return outcome;
+    }
+
+    // BFS over the (a, b) chains through the neighbours of v colored a.
+    // Moved means they can be swapped, Stuck that one reaches a neighbour
+    // of v colored b or grows beyond maxChain.
+    Outcome findChains(uintT v_i, uintT a, uintT b, uint64_t near, uint64_t chainId,
+                       std::vector<uintT> &claimed, std::vector<uintT> &chain)
+    {
+        chain.clear();
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        for (uintT n_i = 0; n_i < vDegree; n_i++)
+        {
+            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+            if (colorData[neigh] == a && chainStamp[neigh] != chainId)
+            {
+                chainStamp[neigh] = chainId;
+                chain.push_back(neigh);
+            }
+        }
+        for (size_t q_i = 0; q_i < chain.size(); q_i++)
+        {
+            const uintT x_i = chain[q_i];
+            const uintT xColor = colorData[x_i];
+            if (xColor == b && nearStamp[x_i] == near)
+                return Stuck;
+            if (chain.size() > maxChain)
+                return Stuck;
+            if (!claimClosed(x_i, v_i, claimed))
+                return Blocked;
+            const uintT other = (xColor == a) ? b : a;
+            const uintT xDegree = GA.V[x_i].getOutDegree();
+            for (uintT n_i = 0; n_i < xDegree; n_i++)
+            {
+                uintT neigh = GA.V[x_i].getOutNeighbor(n_i);
+                if (colorData[neigh] == other && chainStamp[neigh] != chainId)
+                {
+                    chainStamp[neigh] = chainId;
+                    chain.push_back(neigh);
+                }
+            }
+        }
+        return Moved;
+    }
+
+    graph<vertex> &GA;
+    colorVector &colorData;
+    const uintT maxChain;
+    std::atomic<uint64_t> nextStamp;
+    uintT* claims;
+    uint64_t* chainStamp;
+    uint64_t* nearStamp;
+};
+
+// Post-processor for any engine's output (-kempe). The classes are
+// visited from the highest color down (at most -kempe-classes of them),
+// and every vertex of a class is recolored by Kempe interchanges with
+// chains of at most -kempe-chain vertices (1000 by default). A class all
+// of whose vertices moved is eliminated. Stops after -kempe-ms
+// milliseconds (1000 by default), then renumbers the remaining classes.
+// Colorings with conflicts are left alone. Returns the number of classes
+// eliminated.
+template <class vertex>
+uintT kempeEliminate(graph<vertex> &GA, colorVector &colorData, commandLine &P)
+{
+    if (!P.getOption("-kempe"))
+        return 0;
+    timer kempeTimer;
+    kempeTimer.start();
+    const double budget = P.getOptionLongValue("-kempe-ms", 1000) / 1000.0;
+    const uintT maxChain = P.getOptionLongValue("-kempe-chain", 1000);
+    const size_t numVertices = GA.n;
+    const uintT numColors = countColors(colorData);
+    const uintT maxClasses = P.getOptionLongValue("-kempe-classes", numColors);
+
+    if (countConflicts(GA, colorData) != 0)
+    {
+        std::cout << "Kempe: coloring has conflicts, skipped" << std::endl;
+        return 0;
+    }
+
+    KempeEliminator<vertex> eliminator(GA, colorData, maxChain);
+    bool* removed = newA(bool, numColors + 1);
+    parallel_for (0, numColors + 1, [&] (uintT c_i)
+    {
+        removed[c_i] = false;
+    });
+    uintE* pending = newA(uintE, numVertices);
+    uintE* members = newA(uintE, numVertices);
+    uintT* outcomes = newA(uintT, numVertices);
+
+    uintT eliminated = 0;
+    uintT classesTried = 0;
+    uint64_t rounds = 0;
+    for (uintT target = numColors; target-- > 0 && classesTried < maxClasses; )
+    {
+        if (kempeTimer.total() > budget)
+            break;
+        classesTried++;
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            members[v_i] = v_i;
+        });
+        size_t numPending = pbbs::filterf(members, pending, numVertices,
+            [&] (uintE v_i) { return colorData[v_i] == target; });
+
+        bool stuck = false;
+        bool serial = false;
+        while (numPending > 0 && !stuck && kempeTimer.total() <= budget)
+        {
+            rounds++;
+            auto attempt = [&] (size_t p_i)
+            {
+                // Attempts left when the budget runs out count as blocked
+                if (kempeTimer.total() > budget)
+                    outcomes[p_i] = KempeEliminator<vertex>::Blocked;
+                else
+                    outcomes[p_i] = eliminator.recolor(pending[p_i], removed, numColors);
+            };
+            // Attempts that keep blocking each other are run one by one
+            if (serial)
+            {
+                for (size_t p_i = 0; p_i < numPending; p_i++)
+                    attempt(p_i);
+            }
+            else
+                parallel_for (0, numPending, attempt, 1);
+
+            stuck = sequence::reduce<bool>((long) 0, (long) numPending,
+                [] (bool l, bool r) { return l || r; },
+                [&] (long p_i) { return outcomes[p_i] == KempeEliminator<vertex>::Stuck; });
+            size_t moved = sequence::reduce<size_t>((long) 0, (long) numPending, addF<size_t>(),
+                [&] (long p_i) -> size_t { return outcomes[p_i] == KempeEliminator<vertex>::Moved; });
+            serial = (moved == 0);
+            numPending = pbbs::filterf(pending, members, numPending,
+                [&] (uintE v_i) { return colorData[v_i] == target; });
+            std::swap(pending, members);
+        }
+        if (numPending == 0)
+        {
+            removed[target] = true;
+            eliminated++;
+        }
+    }
+
+    // Renumber the remaining classes to [0, numColors - eliminated)
+    uintT* renumber = newA(uintT, numColors + 1);
+    parallel_for (0, numColors + 1, [&] (uintT c_i)
+    {
+        renumber[c_i] = !removed[c_i];
+    });
+    sequence::plusScan(renumber, renumber, numColors + 1);
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        colorData[v_i] = renumber[colorData[v_i]];
+    });
+
+    std::cout << "Kempe: eliminated " << eliminated << " of " << classesTried << " classes tried, colors "
+              << numColors << " -> " << numColors - eliminated << std::endl;
+    std::cout << "\tRounds: " << rounds << std::endl;
+    std::cout << "\tTime: " << setprecision(TIME_PRECISION) << kempeTimer.stop() << std::endl;
+
+    free(removed);
+    free(pending);
+    free(members);
+    free(outcomes);
+    free(renumber);
+    return eliminated;
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef __NEIGHBOR_COLOR_COUNTS_H__
+#define __NEIGHBOR_COLOR_COUNTS_H__
+
+#include <stdint.h>
+#include <cstdlib>
+
+#include "ligra.h"
+#include "forbidden_colors.h"
+#include "neighbor_colors.h"
+
+// Number of neighbours of each vertex having each color, for the push
+// engines. Vertex v only tracks colors [0, min(degree(v) + 2, cap)), which
+// is enough for first-fit, and all counters live in one arena laid out
+// like the CSR edge array. A count can never exceed the degree, so the
+// counters of a vertex are 8 bits wide when its degree allows it, 16 bits
+// for higher degrees and 32 bits only for hubs above 65535; they are
+// updated with atomic fetch-add and cannot wrap around.
+//
+// Colors at or above the tracked range (including the initial
+// UINT_T_MAX "uncolored" value) are not counted. When every tracked color
+// of a capped vertex is taken, the caller has to fall back to scanning the
+// neighbours (see capped()).
+class NeighborColorCounts
+{
+public:
+    // A cap of 0 tracks degree + 2 colors for every vertex
+    template <class vertex>
+    NeighborColorCounts(const graph<vertex> &GA, uintT cap = 0) : numVertices(GA.n)
+    {
+        offsets = newA(size_t, numVertices + 1);
+        slots = newA(uintT, numVertices);
+        widths = newA(uint8_t, numVertices);
+        parallel_for (0, numVertices, [&] (size_t v_i)
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            slots[v_i] = (cap == 0) ? vDegree + 2 : std::min(vDegree + 2, cap);
+            widths[v_i] = (vDegree <= UINT8_MAX) ? 1 : (vDegree <= UINT16_MAX) ? 2 : 4;
+            // Segments start on 4 byte boundaries so that every width is aligned
+            offsets[v_i] = ((size_t) slots[v_i] * widths[v_i] + 3) & ~(size_t) 3;
+        });
+        arenaBytes = sequence::plusScan(offsets, offsets, numVertices);
+        offsets[numVertices] = arenaBytes;
+
+        arena = newA(uint8_t, arenaBytes);
+        parallel_for (0, numVertices, [&] (size_t v_i)
+        {
+            memset(arena + offsets[v_i], 0, offsets[v_i + 1] - offsets[v_i]);
+        });
+    }
+
+    ~NeighborColorCounts()
+    {
+        free(offsets);
+        free(slots);
+        free(widths);
+        free(arena);
+    }
+
+    // Colors [0, tracked(v)) are counted for v
+    inline uintT tracked(uintT v) const
+    {
+        return slots[v];
+    }
+
+    // True when v tracks fewer colors than it may need
+    template <class vertex>
+    inline bool capped(const vertex &v, uintT v_i) const
+    {
+        return slots[v_i] < v.getOutDegree() + 2;
+    }
+
+    inline void add(uintT v, uintT color)
+    {
+        if (color >= slots[v])
+            return;
+        switch (widths[v])
+        {
+            case 1: __sync_fetch_and_add(counter<uint8_t>(v, color), 1); break;
+            case 2: __sync_fetch_and_add(counter<uint16_t>(v, color), 1); break;
+            default: __sync_fetch_and_add(counter<uint32_t>(v, color), 1); break;
+        }
+    }
+
+    // Returns true if this removed the last neighbour with a tracked color
+    inline bool remove(uintT v, uintT color)
+    {
+        if (color >= slots[v])
+            return false;
+        switch (widths[v])
+        {
+            case 1: return __sync_sub_and_fetch(counter<uint8_t>(v, color), 1) == 0;
+            case 2: return __sync_sub_and_fetch(counter<uint16_t>(v, color), 1) == 0;
+            default: return __sync_sub_and_fetch(counter<uint32_t>(v, color), 1) == 0;
+        }
+    }
+
+    // Neighbours of v with the given color, 0 for untracked colors
+    inline uintT count(uintT v, uintT color) const
+    {
+        if (color >= slots[v])
+            return 0;
+        switch (widths[v])
+        {
+            case 1: return *(volatile uint8_t*) counter<uint8_t>(v, color);
+            case 2: return *(volatile uint16_t*) counter<uint16_t>(v, color);
+            default: return *(volatile uint32_t*) counter<uint32_t>(v, color);
+        }
+    }
+
+    // Smallest color >= start that no neighbour of v has, or tracked(v)
+    // if all tracked colors from start on are taken
+    inline uintT firstZero(uintT v, uintT start = 0) const
+    {
+        switch (widths[v])
+        {
+            case 1: return firstZeroIn<uint8_t>(v, start);
+            case 2: return firstZeroIn<uint16_t>(v, start);
+            default: return firstZeroIn<uint32_t>(v, start);
+        }
+    }
+
+    size_t bytes() const
+    {
+        return arenaBytes + numVertices * (sizeof(size_t) + sizeof(uintT) + sizeof(uint8_t));
+    }
+
+private:
+    NeighborColorCounts(const NeighborColorCounts&);
+    NeighborColorCounts& operator=(const NeighborColorCounts&);
+
+    template <class T>
+    inline T* counter(uintT v, uintT color) const
+    {
+        return (T*) (arena + offsets[v]) + color;
+    }
+
+    template <class T>
+    inline uintT firstZeroIn(uintT v, uintT start) const
+    {
+        const volatile T* counts = counter<T>(v, 0);
+        uintT color = start;
+        while (color < slots[v] && counts[color] != 0)
+            color++;
+        return color;
+    }
+
+    size_t numVertices;
+    size_t arenaBytes;
+    size_t* offsets;
+    uintT* slots;
+    uint8_t* widths;
+    uint8_t* arena;
+};
+
+
+// Smallest free color >= start of vertex v according to its counters. If
+// all tracked colors are taken and v is capped, the colors of its
+// neighbours are scanned instead.
+template <class vertex, class Colors>
+inline uintT firstFreeColor(const NeighborColorCounts &counts, const vertex &v, uintT v_i,
+                            const Colors &colorData, ForbiddenColors &forbiddenColors, uintT start = 0)
+{
+    uintT color = counts.firstZero(v_i, start);
+    if (color >= counts.tracked(v_i) && counts.capped(v, v_i))
+    {
+        forbiddenColors.reset(v.getOutDegree() + 1);
+        markNeighborColors(v, colorData, forbiddenColors);
+        color = forbiddenColors.firstFree();
+    }
+    return color;
+}
+
+#endif
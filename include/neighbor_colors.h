@@ -0,0 +1,173 @@
+#ifndef __NEIGHBOR_COLORS_H__
+#define __NEIGHBOR_COLORS_H__
+
+#include <climits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "ligra.h"
+#include "forbidden_colors.h"
+
+// Neighbours ahead of the current one whose color is prefetched
+#define NEIGHBOR_PREFETCH_DISTANCE 16
+
+// Call f with the color of every neighbour of v, in neighbour order.
+// Generic version for any vertex type (compressed vertices included).
+template <class vertex, class Colors, class F>
+inline void mapNeighborColors(const vertex &v, const Colors &colorData, F f)
+{
+    const uintT vDegree = v.getOutDegree();
+    for (uintT n_i = 0; n_i < vDegree; n_i++)
+        f(colorData[v.getOutNeighbor(n_i)]);
+}
+
+// Uncompressed neighbour lists are contiguous, so the colors are fetched
+// with hardware gathers when 32-bit vertex ids and colors allow it, and
+// prefetched NEIGHBOR_PREFETCH_DISTANCE neighbours ahead otherwise.
+template <class Colors, class F>
+inline void mapContiguousNeighborColors(const uintE* neighbors, const uintT vDegree,
+                                        const Colors &colorData, F f)
+{
+    const uintT* colors = colorData.data();
+    uintT n_i = 0;
+#if (defined(__AVX512F__) || defined(__AVX2__)) && !defined(LONG) && !defined(EDGELONG)
+    // Gather indices are signed
+    if (colorData.size() <= (size_t) INT_MAX)
+    {
+#if defined(__AVX512F__)
+        const uintT lanes = 16;
+#else
+        const uintT lanes = 8;
+#endif
+        alignas(64) uintT gathered[lanes];
+        for (; n_i + lanes <= vDegree; n_i += lanes)
+        {
+            for (uintT l_i = n_i + NEIGHBOR_PREFETCH_DISTANCE;
+                 l_i < n_i + lanes + NEIGHBOR_PREFETCH_DISTANCE && l_i < vDegree; l_i++)
+                __builtin_prefetch(colors + neighbors[l_i]);
+#if defined(__AVX512F__)
+            // The unmasked gather leaves its source vector undefined, which
+            // trips -Wmaybe-uninitialized wherever it is inlined
+            __m512i index = _mm512_loadu_si512((const void*) (neighbors + n_i));
+            __m512i colorsOf = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), (__mmask16) 0xFFFF,
+                                                           index, (const void*) colors, 4);
+            _mm512_store_si512((void*) gathered, colorsOf);
+#else
+            __m256i index = _mm256_loadu_si256((const __m256i*) (neighbors + n_i));
+            _mm256_store_si256((__m256i*) gathered, _mm256_i32gather_epi32((const int*) colors, index, 4));
+#endif
+            for (uintT l_i = 0; l_i < lanes; l_i++)
+                f(gathered[l_i]);
+        }
+    }
+#endif
+    for (; n_i < vDegree; n_i++)
+    {
+        if (n_i + NEIGHBOR_PREFETCH_DISTANCE < vDegree)
+            __builtin_prefetch(colors + neighbors[n_i + NEIGHBOR_PREFETCH_DISTANCE]);
+        f(colors[neighbors[n_i]]);
+    }
+}
+
+#ifndef WEIGHTED
+template <class Colors, class F>
+inline void mapNeighborColors(const symmetricVertex &v, const Colors &colorData, F f)
+{
+    mapContiguousNeighborColors(v.getOutNeighbors(), v.getOutDegree(), colorData, f);
+}
+
+template <class Colors, class F>
+inline void mapNeighborColors(const asymmetricVertex &v, const Colors &colorData, F f)
+{
+    mapContiguousNeighborColors(v.getOutNeighbors(), v.getOutDegree(), colorData, f);
+}
+#endif
+
+// Neighbours of a vertex ahead whose colors are prefetched by the pipeline
+#define PIPELINE_PREFETCH_NEIGHBORS 4
+
+// Prefetch stages of PrefetchPipeline. Only the vertex record can be
+// prefetched for vertex types without a contiguous neighbour array.
+template <class vertex>
+inline void prefetchNeighborList(const vertex &v) { }
+
+template <class vertex, class Colors>
+inline void prefetchFirstNeighborColors(const vertex &v, const Colors &colorData) { }
+
+#ifndef WEIGHTED
+template <class vertex>
+inline void prefetchContiguousNeighborList(const vertex &v)
+{
+    if (v.getOutDegree() > 0)
+        __builtin_prefetch(v.getOutNeighbors());
+}
+
+template <class vertex, class Colors>
+inline void prefetchContiguousNeighborColors(const vertex &v, const Colors &colorData)
+{
+    const uintE* neighbors = v.getOutNeighbors();
+    const uintT count = std::min(v.getOutDegree(), (uintT) PIPELINE_PREFETCH_NEIGHBORS);
+    for (uintT n_i = 0; n_i < count; n_i++)
+        __builtin_prefetch(colorData.data() + neighbors[n_i]);
+}
+
+inline void prefetchNeighborList(const symmetricVertex &v) { prefetchContiguousNeighborList(v); }
+inline void prefetchNeighborList(const asymmetricVertex &v) { prefetchContiguousNeighborList(v); }
+
+template <class Colors>
+inline void prefetchFirstNeighborColors(const symmetricVertex &v, const Colors &colorData)
+{
+    prefetchContiguousNeighborColors(v, colorData);
+}
+
+template <class Colors>
+inline void prefetchFirstNeighborColors(const asymmetricVertex &v, const Colors &colorData)
+{
+    prefetchContiguousNeighborColors(v, colorData);
+}
+#endif
+
+// Software pipeline for loops over vertices (-prefetch K). While the
+// vertex at position pos is colored, the vertex record K positions
+// ahead, the neighbour list K/2 ahead and the colors of the first
+// neighbours K/4 ahead are prefetched, each stage using the line brought
+// in by the previous one. vertexAt maps a loop position to a vertex, or
+// to UINT_T_MAX for vertices that will be skipped. K = 0 turns it off.
+template <class vertex, class Colors>
+class PrefetchPipeline
+{
+public:
+    PrefetchPipeline(const graph<vertex> &GA, const Colors &colorData, uintT distance) :
+        GA(GA), colorData(colorData), distance(distance) { }
+
+    template <class VertexAt>
+    inline void ahead(size_t pos, size_t end, VertexAt vertexAt) const
+    {
+        if (distance == 0)
+            return;
+        uintT v_i;
+        if (pos + distance < end && (v_i = vertexAt(pos + distance)) != UINT_T_MAX)
+            __builtin_prefetch(&GA.V[v_i]);
+        if (pos + distance / 2 < end && (v_i = vertexAt(pos + distance / 2)) != UINT_T_MAX)
+            prefetchNeighborList(GA.V[v_i]);
+        if (pos + distance / 4 < end && (v_i = vertexAt(pos + distance / 4)) != UINT_T_MAX)
+            prefetchFirstNeighborColors(GA.V[v_i], colorData);
+    }
+
+private:
+    const graph<vertex> &GA;
+    const Colors &colorData;
+    const uintT distance;
+};
+
+// Mark the colors of all neighbours of v as forbidden
+template <class vertex, class Colors>
+inline void markNeighborColors(const vertex &v, const Colors &colorData,
+                               ForbiddenColors &forbiddenColors)
+{
+    mapNeighborColors(v, colorData, [&] (uintT neighVal) { forbiddenColors.mark(neighVal); });
+}
+
+#endif
@@ -37,6 +37,7 @@
 #include "quickSort.h"
 #include "utils.h"
 #include "graph.h"
+#include "numaPlacement.h"
 using namespace std;
 
 typedef pair<uintE,uintE> intPair;
@@ -139,13 +140,15 @@ _seq<char> readStringFromFile(char *fileName) {
 
 // parallel code for converting a string to words
 words stringToWords(char *Str, long n) {
-  {parallel_for (long i=0; i < n; i++)
-      if (isSpace(Str[i])) Str[i] = 0; }
+  {parallel_for (0, n, [&] (long i)
+  {
+      if (isSpace(Str[i])) Str[i] = 0;
+  }); }
 
   // mark start of words
   bool *FL = newA(bool,n);
   FL[0] = Str[0];
-  {parallel_for (long i=1; i < n; i++) FL[i] = Str[i] && !Str[i-1];}
+  {parallel_for (1, n, [&] (long i) { FL[i] = Str[i] && !Str[i-1]; });}
 
   // offset for each start of word
   _seq<long> Off = sequence::packIndex<long>(FL, n);
@@ -154,7 +157,7 @@ words stringToWords(char *Str, long n) {
 
   // pointer to each start of word
   char **SA = newA(char*, m);
-  {parallel_for (long j=0; j < m; j++) SA[j] = Str+offsets[j];}
+  {parallel_for (0, m, [&] (long j) { SA[j] = Str+offsets[j]; });}
 
   free(offsets); free(FL);
   return words(Str,n,SA,m);
@@ -167,9 +170,9 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
     _seq<char> S = mmapStringFromFile(fname);
     char *bytes = newA(char, S.n);
     // Cannot mutate the graph unless we copy.
-    parallel_for(size_t i=0; i<S.n; i++) {
+    parallel_for(0, S.n, [&] (size_t i) {
       bytes[i] = S.A[i];
-    }
+    });
     if (munmap(S.A, S.n) == -1) {
       perror("munmap");
       exit(-1);
@@ -203,25 +206,32 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
 
   uintT* offsets = newA(uintT,n);
 #ifndef WEIGHTED
-  uintE* edges = newA(uintE,m);
+  uintE* edges = newHugeA(uintE,m);
 #else
-  intE* edges = newA(intE,2*m);
+  intE* edges = newHugeA(intE,2*m);
 #endif
 
-  {parallel_for(long i=0; i < n; i++) offsets[i] = atol(W.Strings[i + 3]);}
-  {parallel_for(long i=0; i<m; i++) {
+  numaPlaceVertexArray(offsets,n,sizeof(uintT));
+  {parallel_for(0, n, [&] (long i) { offsets[i] = atol(W.Strings[i + 3]); });}
+#ifndef WEIGHTED
+  numaPlaceEdgeArray(edges,offsets,n,m,sizeof(uintE));
+#else
+  numaPlaceEdgeArray(edges,offsets,n,m,2*sizeof(intE));
+#endif
+  {parallel_for(0, m, [&] (long i) {
 #ifndef WEIGHTED
       edges[i] = atol(W.Strings[i+n+3]);
 #else
       edges[2*i] = atol(W.Strings[i+n+3]);
       edges[2*i+1] = atol(W.Strings[i+n+m+3]);
 #endif
-    }}
+    });}
   W.del(); // to deal with performance bug in malloc
 
-  vertex* v = newA(vertex,n);
+  vertex* v = newHugeA(vertex,n);
+  numaPlaceVertexArray(v,n,sizeof(vertex));
 
-  {parallel_for (uintT i=0; i < n; i++) {
+  {parallel_for (0, n, [&] (uintT i) {
     uintT o = offsets[i];
     uintT l = ((i == n-1) ? m : offsets[i+1])-offsets[i];
     v[i].setOutDegree(l);
@@ -230,17 +240,17 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
 #else
     v[i].setOutNeighbors(edges+2*o);
 #endif
-    }}
+    });}
 
   if(!isSymmetric) {
     uintT* tOffsets = newA(uintT,n);
-    {parallel_for(long i=0;i<n;i++) tOffsets[i] = INT_T_MAX;}
+    {parallel_for(0, n, [&] (long i) { tOffsets[i] = INT_T_MAX; });}
 #ifndef WEIGHTED
     intPair* temp = newA(intPair,m);
 #else
     intTriple* temp = newA(intTriple,m);
 #endif
-    {parallel_for(long i=0;i<n;i++){
+    {parallel_for(0, n, [&] (long i){
       uintT o = offsets[i];
       for(uintT j=0;j<v[i].getOutDegree();j++){
 #ifndef WEIGHTED
@@ -249,7 +259,7 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
 	temp[o+j] = make_pair(v[i].getOutNeighbor(j),make_pair(i,v[i].getOutWeight(j)));
 #endif
       }
-      }}
+      });}
     free(offsets);
 
 #ifndef WEIGHTED
@@ -268,14 +278,14 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
 
     tOffsets[temp[0].first] = 0;
 #ifndef WEIGHTED
-    uintE* inEdges = newA(uintE,m);
+    uintE* inEdges = newHugeA(uintE,m);
     inEdges[0] = temp[0].second;
 #else
-    intE* inEdges = newA(intE,2*m);
+    intE* inEdges = newHugeA(intE,2*m);
     inEdges[0] = temp[0].second.first;
     inEdges[1] = temp[0].second.second;
 #endif
-    {parallel_for(long i=1;i<m;i++) {
+    {parallel_for(1, m, [&] (long i) {
 #ifndef WEIGHTED
       inEdges[i] = temp[i].second;
 #else
@@ -285,7 +295,7 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
       if(temp[i].first != temp[i-1].first) {
 	tOffsets[temp[i].first] = i;
       }
-      }}
+      });}
 
     free(temp);
 
@@ -293,7 +303,7 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
     //offset to the right
     sequence::scanIBack(tOffsets,tOffsets,n,minF<uintT>(),(uintT)m);
 
-    {parallel_for(long i=0;i<n;i++){
+    {parallel_for(0, n, [&] (long i){
       uintT o = tOffsets[i];
       uintT l = ((i == n-1) ? m : tOffsets[i+1])-tOffsets[i];
       v[i].setInDegree(l);
@@ -302,7 +312,7 @@ graph<vertex> readGraphFromFile(char* fname, bool isSymmetric, bool mmap) {
 #else
       v[i].setInNeighbors(inEdges+2*o);
 #endif
-      }}
+      });}
 
     free(tOffsets);
     Uncompressed_Mem<vertex>* mem = new Uncompressed_Mem<vertex>(v,n,m,edges,inEdges);
@@ -336,41 +346,47 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
   in >> n;
   in.close();
 
+  // the index is read first so that the edges can be placed by vertex
+  // block before they are first touched
+  ifstream in3(idxFile,ifstream::in | ios::binary); //stored as longs
+  in3.seekg(0, ios::end);
+  long size = in3.tellg();
+  in3.seekg(0);
+  if(n != size/sizeof(intT)) { cout << "File size wrong\n"; abort(); }
+
+  char* t = (char *) malloc(size);
+  numaPlaceVertexArray(t,n,sizeof(intT));
+  in3.read(t,size);
+  in3.close();
+  uintT* offsets = (uintT*) t;
+
   ifstream in2(adjFile,ifstream::in | ios::binary); //stored as uints
   in2.seekg(0, ios::end);
-  long size = in2.tellg();
+  size = in2.tellg();
   in2.seekg(0);
 #ifdef WEIGHTED
   long m = size/(2*sizeof(uint));
 #else
   long m = size/sizeof(uint);
 #endif
-  char* s = (char *) malloc(size);
+  char* s = (char *) hugeAlloc(size);
+  numaPlaceEdgeArray(s,offsets,n,m,sizeof(uint));
   in2.read(s,size);
   in2.close();
   uintE* edges = (uintE*) s;
 
-  ifstream in3(idxFile,ifstream::in | ios::binary); //stored as longs
-  in3.seekg(0, ios::end);
-  size = in3.tellg();
-  in3.seekg(0);
-  if(n != size/sizeof(intT)) { cout << "File size wrong\n"; abort(); }
-
-  char* t = (char *) malloc(size);
-  in3.read(t,size);
-  in3.close();
-  uintT* offsets = (uintT*) t;
-
-  vertex* v = newA(vertex,n);
+  vertex* v = newHugeA(vertex,n);
+  numaPlaceVertexArray(v,n,sizeof(vertex));
 #ifdef WEIGHTED
-  intE* edgesAndWeights = newA(intE,2*m);
-  {parallel_for(long i=0;i<m;i++) {
+  intE* edgesAndWeights = newHugeA(intE,2*m);
+  numaPlaceEdgeArray(edgesAndWeights,offsets,n,m,2*sizeof(intE));
+  {parallel_for(0, m, [&] (long i) {
     edgesAndWeights[2*i] = edges[i];
     edgesAndWeights[2*i+1] = edges[i+m];
-    }}
+    });}
   //free(edges);
 #endif
-  {parallel_for(long i=0;i<n;i++) {
+  {parallel_for(0, n, [&] (long i) {
     uintT o = offsets[i];
     uintT l = ((i==n-1) ? m : offsets[i+1])-offsets[i];
       v[i].setOutDegree(l);
@@ -379,17 +395,17 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
 #else
       v[i].setOutNeighbors(edgesAndWeights+2*o);
 #endif
-    }}
+    });}
 
   if(!isSymmetric) {
     uintT* tOffsets = newA(uintT,n);
-    {parallel_for(long i=0;i<n;i++) tOffsets[i] = INT_T_MAX;}
+    {parallel_for(0, n, [&] (long i) { tOffsets[i] = INT_T_MAX; });}
 #ifndef WEIGHTED
     intPair* temp = newA(intPair,m);
 #else
     intTriple* temp = newA(intTriple,m);
 #endif
-    {parallel_for(intT i=0;i<n;i++){
+    {parallel_for(0, n, [&] (intT i){
       uintT o = offsets[i];
       for(uintT j=0;j<v[i].getOutDegree();j++){
 #ifndef WEIGHTED
@@ -398,7 +414,7 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
 	temp[o+j] = make_pair(v[i].getOutNeighbor(j),make_pair(i,v[i].getOutWeight(j)));
 #endif
       }
-      }}
+      });}
     free(offsets);
 #ifndef WEIGHTED
 #ifndef LOWMEM
@@ -415,14 +431,14 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
 #endif
     tOffsets[temp[0].first] = 0;
 #ifndef WEIGHTED
-    uintE* inEdges = newA(uintE,m);
+    uintE* inEdges = newHugeA(uintE,m);
     inEdges[0] = temp[0].second;
 #else
-    intE* inEdges = newA(intE,2*m);
+    intE* inEdges = newHugeA(intE,2*m);
     inEdges[0] = temp[0].second.first;
     inEdges[1] = temp[0].second.second;
 #endif
-    {parallel_for(long i=1;i<m;i++) {
+    {parallel_for(1, m, [&] (long i) {
 #ifndef WEIGHTED
       inEdges[i] = temp[i].second;
 #else
@@ -432,12 +448,12 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
       if(temp[i].first != temp[i-1].first) {
 	tOffsets[temp[i].first] = i;
       }
-      }}
+      });}
     free(temp);
     //fill in offsets of degree 0 vertices by taking closest non-zero
     //offset to the right
     sequence::scanIBack(tOffsets,tOffsets,n,minF<uintT>(),(uintT)m);
-    {parallel_for(long i=0;i<n;i++){
+    {parallel_for(0, n, [&] (long i){
       uintT o = tOffsets[i];
       uintT l = ((i == n-1) ? m : tOffsets[i+1])-tOffsets[i];
       v[i].setInDegree(l);
@@ -446,7 +462,7 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
 #else
       v[i].setInNeighbors((intE*)(inEdges+2*o));
 #endif
-      }}
+      });}
     free(tOffsets);
 #ifndef WEIGHTED
     Uncompressed_Mem<vertex>* mem = new Uncompressed_Mem<vertex>(v,n,m,edges,inEdges);
@@ -468,8 +484,10 @@ graph<vertex> readGraphFromBinary(char* iFile, bool isSymmetric) {
 
 template <class vertex>
 graph<vertex> readGraph(char* iFile, bool compressed, bool symmetric, bool binary, bool mmap) {
-  if(binary) return readGraphFromBinary<vertex>(iFile,symmetric);
-  else return readGraphFromFile<vertex>(iFile,symmetric,mmap);
+  graph<vertex> G = binary ? readGraphFromBinary<vertex>(iFile,symmetric) :
+    readGraphFromFile<vertex>(iFile,symmetric,mmap);
+  hugePageReport();
+  return G;
 }
 
 template <class vertex>
@@ -479,9 +497,9 @@ graph<vertex> readCompressedGraph(char* fname, bool isSymmetric, bool mmap) {
     _seq<char> S = mmapStringFromFile(fname);
     // Cannot mutate graph unless we copy.
     char *bytes = newA(char, S.n);
-    parallel_for(size_t i=0; i<S.n; i++) {
+    parallel_for(0, S.n, [&] (size_t i) {
       bytes[i] = S.A[i];
-    }
+    });
     if (munmap(S.A, S.n) == -1) {
       perror("munmap");
       exit(-1);
@@ -533,20 +551,20 @@ graph<vertex> readCompressedGraph(char* fname, bool isSymmetric, bool mmap) {
 
 
   vertex *V = newA(vertex,n);
-  parallel_for(long i=0;i<n;i++) {
+  parallel_for(0, n, [&] (long i) {
     long o = offsets[i];
     uintT d = Degrees[i];
     V[i].setOutDegree(d);
     V[i].setOutNeighbors(edges+o);
-  }
+  });
 
   if(sizeof(vertex) == sizeof(compressedAsymmetricVertex)){
-    parallel_for(long i=0;i<n;i++) {
+    parallel_for(0, n, [&] (long i) {
       long o = inOffsets[i];
       uintT d = inDegrees[i];
       V[i].setInDegree(d);
       V[i].setInNeighbors(inEdges+o);
-    }
+    });
   }
 
   cout << "creating graph..."<<endl;
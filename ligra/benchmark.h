@@ -0,0 +1,149 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "parallel.h"
+#include "gettime.h"
+#include "graph.h"
+#include "parseCommandLine.h"
+#include "numaPlacement.h"
+using namespace std;
+
+// **************************************************************
+//    BENCHMARK DRIVER
+// **************************************************************
+//
+// Enabled with -bench. For every worker count in -workers (comma
+// separated, defaults to the current worker count) Compute is run
+// -warmup times untimed and then -rounds times timed. The summary of
+// each worker count is printed and, with -csv <file>, appended to a CSV
+// file so that several engines and graphs can be collected in one place.
+
+// Counters a Compute implementation fills in so they can be reported
+// next to the running time of each trial.
+struct benchmarkCounters {
+  long iterations;
+  benchmarkCounters() : iterations(0) {}
+};
+
+static benchmarkCounters benchCounters;
+
+struct sampleSummary {
+  double median, p10, p90, mean, stddev;
+};
+
+// Percentile of sorted samples using linear interpolation between ranks.
+inline double percentile(const vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  double rank = p * (sorted.size() - 1);
+  size_t lo = (size_t) floor(rank), hi = (size_t) ceil(rank);
+  return sorted[lo] + (rank - lo) * (sorted[hi] - sorted[lo]);
+}
+
+inline sampleSummary summarize(vector<double> samples) {
+  sampleSummary s = {0.0, 0.0, 0.0, 0.0, 0.0};
+  if (samples.empty()) return s;
+  sort(samples.begin(), samples.end());
+  s.median = percentile(samples, 0.5);
+  s.p10 = percentile(samples, 0.1);
+  s.p90 = percentile(samples, 0.9);
+  double sum = 0.0;
+  for (size_t i = 0; i < samples.size(); i++) sum += samples[i];
+  s.mean = sum / samples.size();
+  double sq = 0.0;
+  for (size_t i = 0; i < samples.size(); i++)
+    sq += (samples[i] - s.mean) * (samples[i] - s.mean);
+  s.stddev = (samples.size() > 1) ? sqrt(sq / (samples.size() - 1)) : 0.0;
+  return s;
+}
+
+inline vector<int> parseWorkerList(string list) {
+  vector<int> workers;
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    int w = atoi(item.c_str());
+    if (w > 0) workers.push_back(w);
+  }
+  if (workers.empty()) workers.push_back(getWorkers());
+  return workers;
+}
+
+inline string baseName(string path) {
+  size_t slash = path.find_last_of('/');
+  return (slash == string::npos) ? path : path.substr(slash + 1);
+}
+
+inline void writeSummary(ostream& out, const sampleSummary& s) {
+  out << s.median << "," << s.p10 << "," << s.p90 << ","
+      << s.mean << "," << s.stddev;
+}
+
+template<class vertex>
+void Compute(graph<vertex>&, commandLine);
+
+template <class vertex>
+void benchmarkCompute(graph<vertex>& G, commandLine P) {
+  vector<int> workers = parseWorkerList(P.getOptionValue("-workers", string("")));
+  long warmup = P.getOptionLongValue("-warmup", 1);
+  long trials = P.getOptionLongValue("-rounds", 3);
+  string csvFile = P.getOptionValue("-csv", string(""));
+  string engine = P.getOptionValue("-engine", baseName(P.argv[0]));
+  string graphName = P.getArgument(0);
+
+  ofstream csv;
+  if (!csvFile.empty()) {
+    ifstream existing(csvFile.c_str());
+    bool writeHeader = !existing.good() || existing.peek() == EOF;
+    existing.close();
+    csv.open(csvFile.c_str(), ios::app);
+    if (!csv.is_open()) {
+      cout << "Unable to open CSV file: " << csvFile << endl;
+      abort();
+    }
+    if (writeHeader)
+      csv << "engine,graph,workers,warmup,trials,"
+          << "time_median,time_p10,time_p90,time_mean,time_stddev,"
+          << "iter_median,iter_p10,iter_p90,iter_mean,iter_stddev" << endl;
+  }
+
+  for (size_t w_i = 0; w_i < workers.size(); w_i++) {
+    setWorkers(workers[w_i]);
+    numaBindWorkers();
+    for (long r = 0; r < warmup; r++) {
+      Compute(G, P);
+      if (G.transposed) G.transpose();
+    }
+
+    vector<double> times, iterations;
+    for (long r = 0; r < trials; r++) {
+      timer t;
+      benchCounters = benchmarkCounters();
+      t.start();
+      Compute(G, P);
+      times.push_back(t.stop());
+      iterations.push_back((double) benchCounters.iterations);
+      if (G.transposed) G.transpose();
+    }
+
+    sampleSummary ts = summarize(times), is = summarize(iterations);
+    cout << "Benchmark " << engine << " workers=" << workers[w_i]
+         << " trials=" << trials << " median=" << setprecision(3) << ts.median
+         << " p10=" << ts.p10 << " p90=" << ts.p90 << " stddev=" << ts.stddev
+         << " iterations=" << is.median << endl;
+    if (csv.is_open()) {
+      csv << engine << "," << graphName << "," << workers[w_i] << ","
+          << warmup << "," << trials << ",";
+      writeSummary(csv, ts);
+      csv << ",";
+      writeSummary(csv, is);
+      csv << endl;
+    }
+  }
+}
+#endif
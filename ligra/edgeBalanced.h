@@ -0,0 +1,87 @@
+#ifndef EDGE_BALANCED_H
+#define EDGE_BALANCED_H
+#include <stdlib.h>
+#include "parallel.h"
+#include "utils.h"
+#include "binary_search.h"
+#include "index_map.h"
+#include "graph.h"
+#include "vertexSubset.h"
+using namespace std;
+
+// **************************************************************
+//    EDGE-BALANCED PARALLEL LOOPS
+// **************************************************************
+//
+// Splitting a vertex loop by vertex count leaves the worker that gets a
+// hub with thousands of times more edges than the others. These loops
+// split by edges instead, generalising the blocking of
+// edgeMapSparse_no_filter: item j weighs w(j) (degree + 1 for vertices,
+// so that isolated vertices still count), the prefix sums of the weights
+// are cut into blocks of equal weight, and the first item of each block
+// is found by binary search into the prefix sums. A single item heavier
+// than a block still runs on one worker.
+
+// Blocks over items [0, n), built once and reusable for every pass over
+// the same items (the vertices of a graph whose degrees do not change).
+struct edgeBalancedBlocks {
+  long n, numBlocks;
+  uintT* blockStarts;
+
+  // blockWeight = 0 picks blocks small enough for 32 blocks per worker
+  template <class W>
+  edgeBalancedBlocks(long _n, W weight, long blockWeight = 0) : n(_n) {
+    size_t* offsets = newA(size_t, n + 1);
+    {parallel_for(0, n, [&] (long i) { offsets[i] = weight(i); });}
+    size_t total = (n > 0) ? sequence::plusScan(offsets, offsets, (size_t) n) : 0;
+    offsets[n] = total;
+    if (blockWeight <= 0)
+      blockWeight = max(1024L, (long) (total / (32L * getWorkers())));
+    numBlocks = max(1L, (long) nblocks((long) total, blockWeight));
+
+    blockStarts = newA(uintT, numBlocks + 1);
+    auto offsets_m = make_in_imap<size_t>(n, [&] (size_t i) { return offsets[i]; });
+    auto lt = [] (const size_t& l, const size_t& r) { return l < r; };
+    {parallel_for(0, numBlocks, [&] (long b) {
+      blockStarts[b] = pbbs::binary_search(offsets_m, (size_t) b * blockWeight, lt);
+    });}
+    blockStarts[numBlocks] = n;
+    free(offsets);
+  }
+
+  // Calls f(j) for every item, one block per task
+  template <class F>
+  void run(F f) const {
+    parallel_for_1(0, numBlocks, [&] (long b) {
+      for (uintT j = blockStarts[b]; j < blockStarts[b+1]; j++) f(j);
+    });
+  }
+
+  void del() { free(blockStarts); }
+};
+
+// Blocks over all vertices of GA, weighted by out-degree
+template <class vertex>
+edgeBalancedBlocks vertexBlocks(graph<vertex>& GA, long blockWeight = 0) {
+  return edgeBalancedBlocks(GA.n, [&] (long i) {
+      return (size_t) GA.V[i].getOutDegree() + 1; }, blockWeight);
+}
+
+// Calls f(v) for every vertex of GA
+template <class vertex, class F>
+void edgeBalancedFor(graph<vertex>& GA, F f, long blockWeight = 0) {
+  edgeBalancedBlocks blocks = vertexBlocks(GA, blockWeight);
+  blocks.run(f);
+  blocks.del();
+}
+
+// Calls f(v) for every vertex of the frontier vs
+template <class vertex, class F>
+void edgeBalancedFor(graph<vertex>& GA, vertexSubset& vs, F f, long blockWeight = 0) {
+  vs.toSparse();
+  edgeBalancedBlocks blocks(vs.numNonzeros(), [&] (long j) {
+      return (size_t) GA.V[vs.vtx(j)].getOutDegree() + 1; }, blockWeight);
+  blocks.run([&] (uintT j) { f(vs.vtx(j)); });
+  blocks.del();
+}
+#endif
@@ -6,6 +6,7 @@
 #include "vertex.h"
 #include "compressedVertex.h"
 #include "parallel.h"
+#include "pageAlloc.h"
 using namespace std;
 
 // **************************************************************
@@ -33,9 +34,9 @@ public:
   void del() {
     if (allocatedInplace == NULL)
       for (long i=0; i < n; i++) V[i].del();
-    else free(allocatedInplace);
-    free(V);
-    if(inEdges != NULL) free(inEdges);
+    else hugeFree(allocatedInplace);
+    hugeFree(V);
+    if(inEdges != NULL) hugeFree(inEdges);
   }
 };
 
@@ -78,9 +79,9 @@ graph(vertex* _V, long _n, long _m, Deletable* _D, uintE* _flags) : V(_V),
   void transpose() {
     if ((sizeof(vertex) == sizeof(asymmetricVertex)) ||
         (sizeof(vertex) == sizeof(compressedAsymmetricVertex))) {
-      parallel_for(long i=0;i<n;i++) {
+      parallel_for(0, n, [&] (long i) {
         V[i].flipEdges();
-      }
+      });
       transposed = !transposed;
     }
   }
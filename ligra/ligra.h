@@ -41,6 +41,11 @@
 #include "gettime.h"
 #include "index_map.h"
 #include "edgeMap_utils.h"
+#include "numaPlacement.h"
+#include "benchmark.h"
+#include "symmetrize.h"
+#include "reverseEdges.h"
+#include "edgeBalanced.h"
 using namespace std;
 
 //*****START FRAMEWORK*****
@@ -63,20 +68,20 @@ vertexSubsetData<data> edgeMapDense(graph<vertex> GA, VS& vertexSubset, F &f, co
   if (should_output(fl)) {
     D* next = newA(D, n);
     auto g = get_emdense_gen<data>(next);
-    parallel_for (long v=0; v<n; v++) {
+    parallel_for (0, n, [&] (long v) {
       std::get<0>(next[v]) = 0;
       if (f.cond(v)) {
         G[v].decodeInNghBreakEarly(v, vertexSubset, f, g, fl & dense_parallel);
       }
-    }
+    });
     return vertexSubsetData<data>(n, next);
   } else {
     auto g = get_emdense_nooutput_gen<data>();
-    parallel_for (long v=0; v<n; v++) {
+    parallel_for (0, n, [&] (long v) {
       if (f.cond(v)) {
         G[v].decodeInNghBreakEarly(v, vertexSubset, f, g, fl & dense_parallel);
       }
-    }
+    });
     return vertexSubsetData<data>(n);
   }
 }
@@ -89,20 +94,20 @@ vertexSubsetData<data> edgeMapDenseForward(graph<vertex> GA, VS& vertexSubset, F
   if (should_output(fl)) {
     D* next = newA(D, n);
     auto g = get_emdense_forward_gen<data>(next);
-    parallel_for(long i=0;i<n;i++) { std::get<0>(next[i]) = 0; }
-    parallel_for (long i=0; i<n; i++) {
+    parallel_for(0, n, [&] (long i) { std::get<0>(next[i]) = 0; });
+    parallel_for (0, n, [&] (long i) {
       if (vertexSubset.isIn(i)) {
         G[i].decodeOutNgh(i, f, g);
       }
-    }
+    });
     return vertexSubsetData<data>(n, next);
   } else {
     auto g = get_emdense_forward_nooutput_gen<data>();
-    parallel_for (long i=0; i<n; i++) {
+    parallel_for (0, n, [&] (long i) {
       if (vertexSubset.isIn(i)) {
         G[i].decodeOutNgh(i, f, g);
       }
-    }
+    });
     return vertexSubsetData<data>(n);
   }
 }
@@ -120,18 +125,18 @@ vertexSubsetData<data> edgeMapSparse(graph<vertex>& GA, vertex* frontierVertices
     outEdgeCount = sequence::plusScan(offsets, offsets, m);
     outEdges = newA(S, outEdgeCount);
     auto g = get_emsparse_gen<data>(outEdges);
-    parallel_for (size_t i = 0; i < m; i++) {
+    parallel_for (0, m, [&] (size_t i) {
       uintT v = indices.vtx(i), o = offsets[i];
       vertex vert = frontierVertices[i];
       vert.decodeOutNghSparse(v, o, f, g);
-    }
+    });
   } else {
     auto g = get_emsparse_nooutput_gen<data>();
-    parallel_for (size_t i = 0; i < m; i++) {
+    parallel_for (0, m, [&] (size_t i) {
       uintT v = indices.vtx(i);
       vertex vert = frontierVertices[i];
       vert.decodeOutNghSparse(v, 0, f, g);
-    }
+    });
   }
 
   if (should_output(fl)) {
@@ -139,7 +144,7 @@ vertexSubsetData<data> edgeMapSparse(graph<vertex>& GA, vertex* frontierVertices
     if (fl & remove_duplicates) {
       if (GA.flags == NULL) {
         GA.flags = newA(uintE, n);
-        parallel_for(long i=0;i<n;i++) { GA.flags[i]=UINT_E_MAX; }
+        parallel_for(0, n, [&] (long i) { GA.flags[i]=UINT_E_MAX; });
       }
       auto get_key = [&] (size_t i) -> uintE& { return std::get<0>(outEdges[i]); };
       remDuplicates(get_key, GA.flags, outEdgeCount, n);
@@ -173,12 +178,12 @@ vertexSubsetData<data> edgeMapSparse_no_filter(graph<vertex>& GA,
 
   auto offsets_m = make_in_imap<uintT>(m, [&] (size_t i) { return offsets[i]; });
   auto lt = [] (const uintT& l, const uintT& r) { return l < r; };
-  parallel_for(size_t i=0; i<n_blocks; i++) {
+  parallel_for(0, n_blocks, [&] (size_t i) {
     size_t s_val = i*b_size;
     block_offs[i] = pbbs::binary_search(offsets_m, s_val, lt);
-  }
+  });
   block_offs[n_blocks] = m;
-  parallel_for (size_t i=0; i<n_blocks; i++) {
+  parallel_for (0, n_blocks, [&] (size_t i) {
     if ((i == n_blocks-1) || block_offs[i] != block_offs[i+1]) {
       // start and end are offsets in [m]
       size_t start = block_offs[i];
@@ -194,14 +199,14 @@ vertexSubsetData<data> edgeMapSparse_no_filter(graph<vertex>& GA,
     } else {
       cts[i] = 0;
     }
-  }
+  });
 
   long outSize = sequence::plusScan(cts, cts, n_blocks);
   cts[n_blocks] = outSize;
 
   S* out = newA(S, outSize);
 
-  parallel_for (size_t i=0; i<n_blocks; i++) {
+  parallel_for (0, n_blocks, [&] (size_t i) {
     if ((i == n_blocks-1) || block_offs[i] != block_offs[i+1]) {
       size_t start = block_offs[i];
       size_t start_o = offsets[start];
@@ -211,13 +216,13 @@ vertexSubsetData<data> edgeMapSparse_no_filter(graph<vertex>& GA,
         out[out_off + j] = outEdges[start_o + j];
       }
     }
-  }
+  });
   free(outEdges); free(cts); free(block_offs);
 
   if (fl & remove_duplicates) {
     if (GA.flags == NULL) {
       GA.flags = newA(uintE, n);
-      parallel_for(size_t i=0;i<n;i++) { GA.flags[i]=UINT_E_MAX; }
+      parallel_for(0, n, [&] (size_t i) { GA.flags[i]=UINT_E_MAX; });
     }
     auto get_key = [&] (size_t i) -> uintE& { return std::get<0>(out[i]); };
     remDuplicates(get_key, GA.flags, outSize, n);
@@ -249,12 +254,12 @@ vertexSubsetData<data> edgeMapData(graph<vertex>& GA, VS &vs, F f,
     vs.toSparse();
     degrees = newA(uintT, m);
     frontierVertices = newA(vertex,m);
-    {parallel_for (size_t i=0; i < m; i++) {
+    {parallel_for (0, m, [&] (size_t i) {
 	uintE v_id = vs.vtx(i);
 	vertex v = G[v_id];
 	degrees[i] = v.getOutDegree();
 	frontierVertices[i] = v;
-      }}
+      });}
     outDegrees = sequence::plusReduce(degrees, m);
     if (outDegrees == 0) return vertexSubsetData<data>(numVertices);
   }
@@ -308,22 +313,22 @@ vertexSubsetData<uintE> packEdges(graph<vertex>& GA, vertexSubset& vs, P& p, con
   uintE* tmp1 = newA(uintE, outEdgeCount);
   uintE* tmp2 = newA(uintE, outEdgeCount);
   if (should_output(fl)) {
-    parallel_for (size_t i=0; i<m; i++) {
+    parallel_for (0, m, [&] (size_t i) {
       uintE v = vs.vtx(i);
       size_t offset = degrees[i];
       auto bitsOff = &(bits[offset]); auto tmp1Off = &(tmp1[offset]);
       auto tmp2Off = &(tmp2[offset]);
       size_t ct = G[v].packOutNgh(v, p, bitsOff, tmp1Off, tmp2Off);
       outV[i] = make_tuple(v, ct);
-    }
+    });
   } else {
-    parallel_for (size_t i=0; i<m; i++) {
+    parallel_for (0, m, [&] (size_t i) {
       uintE v = vs.vtx(i);
       size_t offset = degrees[i];
       auto bitsOff = &(bits[offset]); auto tmp1Off = &(tmp1[offset]);
       auto tmp2Off = &(tmp2[offset]);
       size_t ct = G[v].packOutNgh(v, p, bitsOff, tmp1Off, tmp2Off);
-    }
+    });
   }
   free(bits); free(tmp1); free(tmp2);
   if (should_output(fl)) {
@@ -349,16 +354,16 @@ vertexSubsetData<uintE> edgeMapFilter(graph<vertex>& GA, vertexSubset& vs, P& p,
     outV = newA(S, vs.size());
   }
   if (should_output(fl)) {
-    parallel_for (size_t i=0; i<m; i++) {
+    parallel_for (0, m, [&] (size_t i) {
       uintE v = vs.vtx(i);
       size_t ct = G[v].countOutNgh(v, p);
       outV[i] = make_tuple(v, ct);
-    }
+    });
   } else {
-    parallel_for (size_t i=0; i<m; i++) {
+    parallel_for (0, m, [&] (size_t i) {
       uintE v = vs.vtx(i);
       size_t ct = G[v].countOutNgh(v, p);
-    }
+    });
   }
   if (should_output(fl)) {
     return vertexSubsetData<uintE>(n, m, outV);
@@ -376,15 +381,15 @@ template <class F, class VS, typename std::enable_if<
 void vertexMap(VS& V, F f) {
   size_t n = V.numRows(), m = V.numNonzeros();
   if(V.dense()) {
-    parallel_for(long i=0;i<n;i++) {
+    parallel_for(0, n, [&] (long i) {
       if(V.isIn(i)) {
         f(i, V.ithData(i));
       }
-    }
+    });
   } else {
-    parallel_for(long i=0;i<m;i++) {
+    parallel_for(0, m, [&] (long i) {
       f(V.vtx(i), V.vtxData(i));
-    }
+    });
   }
 }
 
@@ -393,15 +398,15 @@ template <class VS, class F, typename std::enable_if<
 void vertexMap(VS& V, F f) {
   size_t n = V.numRows(), m = V.numNonzeros();
   if(V.dense()) {
-    parallel_for(long i=0;i<n;i++) {
+    parallel_for(0, n, [&] (long i) {
       if(V.isIn(i)) {
         f(i);
       }
-    }
+    });
   } else {
-    parallel_for(long i=0;i<m;i++) {
+    parallel_for(0, m, [&] (long i) {
       f(V.vtx(i));
-    }
+    });
   }
 }
 
@@ -412,9 +417,11 @@ vertexSubset vertexFilter(vertexSubset V, F filter) {
   long n = V.numRows(), m = V.numNonzeros();
   V.toDense();
   bool* d_out = newA(bool,n);
-  {parallel_for(long i=0;i<n;i++) d_out[i] = 0;}
-  {parallel_for(long i=0;i<n;i++)
-      if(V.d[i]) d_out[i] = filter(i);}
+  {parallel_for(0, n, [&] (long i) { d_out[i] = 0; });}
+  {parallel_for(0, n, [&] (long i)
+  {
+      if(V.d[i]) d_out[i] = filter(i);
+  });}
   return vertexSubset(n,d_out);
 }
 
@@ -426,10 +433,10 @@ vertexSubset vertexFilter2(vertexSubset V, F filter) {
   }
   bool* bits = newA(bool, m);
   V.toSparse();
-  {parallel_for(size_t i=0; i<m; i++) {
+  {parallel_for(0, m, [&] (size_t i) {
     uintE v = V.vtx(i);
     bits[i] = filter(v);
-  }}
+  });}
   auto v_imap = make_in_imap<uintE>(m, [&] (size_t i) { return V.vtx(i); });
   auto bits_m = make_in_imap<bool>(m, [&] (size_t i) { return bits[i]; });
   auto out = pbbs::pack(v_imap, bits_m);
@@ -446,10 +453,10 @@ vertexSubset vertexFilter2(vertexSubsetData<data> V, F filter) {
   }
   bool* bits = newA(bool, m);
   V.toSparse();
-  parallel_for(size_t i=0; i<m; i++) {
+  parallel_for(0, m, [&] (size_t i) {
     auto t = V.vtxAndData(i);
     bits[i] = filter(std::get<0>(t), std::get<1>(t));
-  }
+  });
   auto v_imap = make_in_imap<uintE>(m, [&] (size_t i) { return V.vtx(i); });
   auto bits_m = make_in_imap<bool>(m, [&] (size_t i) { return bits[i]; });
   auto out = pbbs::pack(v_imap, bits_m);
@@ -475,27 +482,36 @@ int parallel_main(int argc, char* argv[]) {
   bool mmap = P.getOptionValue("-m");
   //cout << "mmap = " << mmap << endl;
   long rounds = P.getOptionLongValue("-rounds",3);
+  bool bench = P.getOption("-bench");
+  hugePageInit(P);
+  numaInit(P);
   if (compressed) {
     if (symmetric) {
       graph<compressedSymmetricVertex> G =
         readCompressedGraph<compressedSymmetricVertex>(iFile,symmetric,mmap); //symmetric graph
-      Compute(G,P);
-      for(int r=0;r<rounds;r++) {
-        startTime();
+      if (bench) benchmarkCompute(G,P);
+      else {
         Compute(G,P);
-        nextTime("Running time");
+        for(int r=0;r<rounds;r++) {
+          startTime();
+          Compute(G,P);
+          nextTime("Running time");
+        }
       }
       G.del();
     } else {
       graph<compressedAsymmetricVertex> G =
         readCompressedGraph<compressedAsymmetricVertex>(iFile,symmetric,mmap); //asymmetric graph
-      Compute(G,P);
-      if(G.transposed) G.transpose();
-      for(int r=0;r<rounds;r++) {
-        startTime();
+      if (bench) benchmarkCompute(G,P);
+      else {
         Compute(G,P);
-        nextTime("Running time");
         if(G.transposed) G.transpose();
+        for(int r=0;r<rounds;r++) {
+          startTime();
+          Compute(G,P);
+          nextTime("Running time");
+          if(G.transposed) G.transpose();
+        }
       }
       G.del();
     }
@@ -503,23 +519,38 @@ int parallel_main(int argc, char* argv[]) {
     if (symmetric) {
       graph<symmetricVertex> G =
         readGraph<symmetricVertex>(iFile,compressed,symmetric,binary,mmap); //symmetric graph
-      Compute(G,P);
-      for(int r=0;r<rounds;r++) {
-        startTime();
+      if (bench) benchmarkCompute(G,P);
+      else {
         Compute(G,P);
-        nextTime("Running time");
+        for(int r=0;r<rounds;r++) {
+          startTime();
+          Compute(G,P);
+          nextTime("Running time");
+        }
       }
       G.del();
     } else {
+#ifndef WEIGHTED
+      // Directed inputs are symmetrized in memory rather than requiring a
+      // symmetrized copy on disk
+      graph<asymmetricVertex> AG =
+        readGraph<asymmetricVertex>(iFile,compressed,symmetric,binary,mmap); //asymmetric graph
+      graph<symmetricVertex> G = symmetrizeGraph(AG);
+      AG.del();
+#else
       graph<asymmetricVertex> G =
         readGraph<asymmetricVertex>(iFile,compressed,symmetric,binary,mmap); //asymmetric graph
-      Compute(G,P);
-      if(G.transposed) G.transpose();
-      for(int r=0;r<rounds;r++) {
-        startTime();
+#endif
+      if (bench) benchmarkCompute(G,P);
+      else {
         Compute(G,P);
-        nextTime("Running time");
         if(G.transposed) G.transpose();
+        for(int r=0;r<rounds;r++) {
+          startTime();
+          Compute(G,P);
+          nextTime("Running time");
+          if(G.transposed) G.transpose();
+        }
       }
       G.del();
     }
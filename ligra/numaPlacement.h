@@ -0,0 +1,228 @@
+#ifndef NUMA_PLACEMENT_H
+#define NUMA_PLACEMENT_H
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <atomic>
+#include <vector>
+#include "parallel.h"
+#include "parseCommandLine.h"
+#ifdef NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+using namespace std;
+
+// **************************************************************
+//    NUMA PLACEMENT
+// **************************************************************
+//
+// -numa interleave  spreads every allocation made after start-up
+//                   round-robin over all nodes (process memory policy).
+// -numa partition   splits the large vertex-indexed arrays (offsets,
+//                   vertices, colors, scheduler bitsets) into one
+//                   contiguous block per node, and the edge array along
+//                   the same vertex boundaries, so that the worker
+//                   processing a block of vertices finds them locally.
+// -numa-bind        pins each worker to the node owning its share of the
+//                   iteration space (worker w of p runs on node w*nodes/p).
+//
+// With NUMA defined (make NUMA=1) libnuma is used, otherwise the
+// mbind/set_mempolicy system calls and the node cpulists in sysfs.
+// Without any option nothing changes and memory is placed on first touch.
+
+#ifndef NUMA
+#define MPOL_PREFERRED 1
+#define MPOL_INTERLEAVE 3
+#define MPOL_MF_MOVE (1<<1)
+#endif
+
+#define NUMA_MAX_NODES 64
+
+enum numaPolicy { NUMA_FIRST_TOUCH, NUMA_INTERLEAVE, NUMA_PARTITION };
+
+struct numaSettings {
+  numaPolicy policy;
+  bool bindWorkers;
+  int nodes;
+  numaSettings() : policy(NUMA_FIRST_TOUCH), bindWorkers(false), nodes(1) {}
+};
+
+static numaSettings numaConfig;
+
+inline int numaNodeCount() {
+#ifdef NUMA
+  if (numa_available() < 0) return 1;
+  return max(1, min(numa_num_configured_nodes(), NUMA_MAX_NODES));
+#else
+  int nodes = 0;
+  struct stat st;
+  while (nodes < NUMA_MAX_NODES) {
+    stringstream ss; ss << "/sys/devices/system/node/node" << nodes;
+    if (stat(ss.str().c_str(), &st) != 0) break;
+    nodes++;
+  }
+  return max(nodes, 1);
+#endif
+}
+
+inline long numaMbind(void* addr, size_t len, int mode, unsigned long nodemask) {
+#ifdef NUMA
+  return mbind(addr, len, mode, &nodemask, NUMA_MAX_NODES + 1, MPOL_MF_MOVE);
+#else
+  return syscall(SYS_mbind, addr, len, mode, &nodemask,
+                 NUMA_MAX_NODES + 1, MPOL_MF_MOVE);
+#endif
+}
+
+// Places bytes [lo, hi) of an array on node. Pages straddling a block
+// boundary go to the block that starts on them.
+inline void numaPlaceRange(char* base, size_t lo, size_t hi, int node) {
+  static const size_t page = sysconf(_SC_PAGESIZE);
+  size_t start = ((size_t) (base + lo)) & ~(page - 1);
+  size_t end = ((size_t) (base + hi)) & ~(page - 1);
+  if (end <= start) return;
+  numaMbind((void*) start, end - start, MPOL_PREFERRED, 1UL << node);
+}
+
+// Partitions an array indexed by vertex into one block per node. Pages
+// that were already touched are migrated.
+inline void numaPlaceVertexArray(void* A, long n, size_t elemSize) {
+  if (numaConfig.policy != NUMA_PARTITION || A == NULL) return;
+  int nodes = numaConfig.nodes;
+  size_t bytes = n * elemSize;
+  static const size_t page = sysconf(_SC_PAGESIZE);
+  for (int k = 0; k < nodes; k++) {
+    size_t lo = (size_t) (k * n / nodes) * elemSize;
+    size_t hi = (k == nodes-1) ? bytes + page : (size_t) ((k+1) * n / nodes) * elemSize;
+    numaPlaceRange((char*) A, lo, hi, k);
+  }
+}
+
+// Partitions an edge array along the vertex blocks of
+// numaPlaceVertexArray, using the (exclusive prefix sum) offsets.
+inline void numaPlaceEdgeArray(void* E, uintT* offsets, long n, long m,
+                               size_t elemSize) {
+  if (numaConfig.policy != NUMA_PARTITION || E == NULL) return;
+  int nodes = numaConfig.nodes;
+  static const size_t page = sysconf(_SC_PAGESIZE);
+  for (int k = 0; k < nodes; k++) {
+    long vlo = k * n / nodes, vhi = (k+1) * n / nodes;
+    size_t lo = (size_t) ((vlo < n) ? offsets[vlo] : m) * elemSize;
+    size_t hi = (k == nodes-1) ? m * elemSize + page :
+      (size_t) ((vhi < n) ? offsets[vhi] : m) * elemSize;
+    numaPlaceRange((char*) E, lo, hi, k);
+  }
+}
+
+inline bool numaRunOnNode(int node) {
+#ifdef NUMA
+  return numa_run_on_node(node) == 0;
+#else
+  stringstream ss; ss << "/sys/devices/system/node/node" << node << "/cpulist";
+  ifstream in(ss.str().c_str());
+  string list;
+  if (!(in >> list)) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  stringstream ls(list);
+  string range;
+  while (getline(ls, range, ',')) {
+    size_t dash = range.find('-');
+    int lo = atoi(range.substr(0, dash).c_str());
+    int hi = (dash == string::npos) ? lo : atoi(range.substr(dash + 1).c_str());
+    for (int c = lo; c <= hi && c < CPU_SETSIZE; c++) CPU_SET(c, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#endif
+}
+
+// Pins every worker to its node. The native scheduler binds every worker
+// thread as it starts, so it is restarted with the hook installed, and
+// later worker count changes bind their threads too. OpenMP runs a
+// parallel region, which calls its body exactly once per thread. Cilk has
+// no such hook, so a worker binds itself the first time it picks up an
+// iteration of a loop that is repeated until all workers have. Except
+// with the native scheduler, has to be repeated whenever the worker count
+// changes.
+inline void numaBindWorkers() {
+  if (!numaConfig.bindWorkers || numaConfig.nodes < 2) return;
+  int p = getWorkers();
+  atomic<int> failed(0);
+#if defined(HOMEGROWN)
+  homegrown::workerStartHook() = [&failed] (int w, int workers) {
+    if (!numaRunOnNode((long) w * numaConfig.nodes / workers)) failed++; };
+  setWorkers(p);
+  homegrown::workerStartHook() = [] (int w, int workers) {
+    numaRunOnNode((long) w * numaConfig.nodes / workers); };
+  int unbound = 0;
+#elif defined(OPENMP)
+  _Pragma("omp parallel num_threads(p)")
+  {
+    if (!numaRunOnNode((long) omp_get_thread_num() * numaConfig.nodes / p)) failed++;
+  }
+  int unbound = 0;
+#elif defined(CILK) || defined(CILKP)
+  vector<atomic<bool>> bound(p);
+  for (int w = 0; w < p; w++) bound[w] = false;
+  atomic<int> boundWorkers(0);
+  for (int attempt = 0; attempt < 1000 && boundWorkers.load() < p; attempt++) {
+    parallel_for_1 (0, 64 * p, [&] (long i) {
+      int w = getWorkerNum();
+      bool expected = false;
+      if (bound[w].compare_exchange_strong(expected, true)) {
+        if (!numaRunOnNode((long) w * numaConfig.nodes / p)) failed++;
+        boundWorkers++;
+      }
+    });
+  }
+  int unbound = p - boundWorkers.load();
+#else
+  if (!numaRunOnNode(0)) failed++;
+  int unbound = 0;
+#endif
+  if (failed.load() > 0 || unbound > 0)
+    cout << "NUMA: unable to bind " << failed.load() + unbound << " of "
+         << p << " workers" << endl;
+}
+
+// Reads the -numa options and sets the process memory policy. Called once
+// before the graph is loaded.
+inline void numaInit(commandLine& P) {
+  string policy = P.getOptionValue("-numa", string(""));
+  numaConfig.bindWorkers = P.getOption("-numa-bind");
+  if (policy.empty() && !numaConfig.bindWorkers) return;
+
+  numaConfig.nodes = numaNodeCount();
+  if (policy == "interleave") numaConfig.policy = NUMA_INTERLEAVE;
+  else if (policy == "partition") numaConfig.policy = NUMA_PARTITION;
+  else if (!policy.empty()) {
+    cout << "Unknown NUMA policy: " << policy << endl;
+    abort();
+  }
+
+  if (numaConfig.policy == NUMA_INTERLEAVE) {
+#ifdef NUMA
+    numa_set_interleave_mask(numa_all_nodes_ptr);
+#else
+    unsigned long mask = (numaConfig.nodes >= NUMA_MAX_NODES) ? ~0UL :
+      (1UL << numaConfig.nodes) - 1;
+    if (syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, &mask, NUMA_MAX_NODES + 1) != 0)
+      cout << "NUMA: unable to set interleave policy" << endl;
+#endif
+  }
+  numaBindWorkers();
+
+  cout << "NUMA: " << numaConfig.nodes << " node(s), "
+       << (numaConfig.policy == NUMA_INTERLEAVE ? "interleaved" :
+           numaConfig.policy == NUMA_PARTITION ? "partitioned" : "first-touch")
+       << " placement" << (numaConfig.bindWorkers ? ", workers bound" : "")
+       << endl;
+}
+#endif
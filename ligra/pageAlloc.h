@@ -0,0 +1,194 @@
+#ifndef PAGE_ALLOC_H
+#define PAGE_ALLOC_H
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <map>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "parseCommandLine.h"
+using namespace std;
+
+// **************************************************************
+//    LARGE PAGE ALLOCATION
+// **************************************************************
+//
+// Arrays of at least -huge-threshold MB (default 8) can be backed by
+// large pages to cut dTLB misses on random lookups:
+//   -hugepages thp   2MB aligned and advised with MADV_HUGEPAGE
+//   -hugepages 2mb   explicit 2MB pages (MAP_HUGETLB)
+//   -hugepages 1gb   explicit 1GB pages (MAP_HUGETLB)
+// Explicit pages need a reserved hugetlbfs pool
+// (/sys/kernel/mm/hugepages); when it is exhausted the allocation falls
+// back to the THP path.
+//
+// newA goes through pageAlloc, whose memory is always released with
+// free(), so it never uses explicit pages. Arrays whose owner knows how
+// they are released (the graph arrays freed by Uncompressed_Mem, vectors
+// using hugeAllocator) go through hugeAlloc/hugeFree, which may.
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+enum hugePageMode { HUGE_NONE, HUGE_THP, HUGE_2MB, HUGE_1GB };
+
+struct hugePageSettings {
+  hugePageMode mode;
+  size_t threshold;
+  // bytes currently on explicit pages, bytes advised for THP so far, and
+  // the number of explicit requests that fell back to THP
+  long explicitBytes, advisedBytes, fallbacks;
+  hugePageSettings() : mode(HUGE_NONE), threshold(8L << 20),
+    explicitBytes(0), advisedBytes(0), fallbacks(0) {}
+};
+
+static hugePageSettings hugeConfig;
+
+// Explicitly mapped regions and their mapped lengths
+static map<void*, size_t> hugeRegions;
+static mutex hugeRegionsLock;
+
+// free()-compatible: large arrays are aligned to 2MB and advised for THP.
+inline void* pageAlloc(size_t bytes) {
+  const size_t huge = 1L << 21;
+  if (hugeConfig.mode == HUGE_NONE || bytes < max(hugeConfig.threshold, huge))
+    return malloc(bytes);
+  void* p = NULL;
+  if (posix_memalign(&p, huge, bytes) != 0) return malloc(bytes);
+#ifdef MADV_HUGEPAGE
+  if (madvise(p, (bytes + huge - 1) & ~(huge - 1), MADV_HUGEPAGE) == 0)
+    __sync_fetch_and_add(&hugeConfig.advisedBytes, (long) bytes);
+#endif
+  return p;
+}
+
+inline void* hugeAlloc(size_t bytes) {
+  if (hugeConfig.mode != HUGE_2MB && hugeConfig.mode != HUGE_1GB)
+    return pageAlloc(bytes);
+  const bool gb = (hugeConfig.mode == HUGE_1GB);
+  const size_t page = gb ? (1L << 30) : (1L << 21);
+  if (bytes < max(hugeConfig.threshold, (size_t) 1L << 21)) return malloc(bytes);
+  const size_t len = (bytes + page - 1) & ~(page - 1);
+  void* p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                 (gb ? MAP_HUGE_1GB : MAP_HUGE_2MB), -1, 0);
+  if (p == MAP_FAILED) {
+    __sync_fetch_and_add(&hugeConfig.fallbacks, 1L);
+    return pageAlloc(bytes);
+  }
+  {
+    lock_guard<mutex> guard(hugeRegionsLock);
+    hugeRegions[p] = len;
+  }
+  __sync_fetch_and_add(&hugeConfig.explicitBytes, (long) len);
+  return p;
+}
+
+// Releases memory from hugeAlloc, pageAlloc or malloc.
+inline void hugeFree(void* p) {
+  if (p == NULL) return;
+  if (hugeConfig.mode == HUGE_2MB || hugeConfig.mode == HUGE_1GB) {
+    size_t len = 0;
+    {
+      lock_guard<mutex> guard(hugeRegionsLock);
+      map<void*, size_t>::iterator it = hugeRegions.find(p);
+      if (it != hugeRegions.end()) { len = it->second; hugeRegions.erase(it); }
+    }
+    if (len > 0) {
+      munmap(p, len);
+      __sync_fetch_and_add(&hugeConfig.explicitBytes, -(long) len);
+      return;
+    }
+  }
+  free(p);
+}
+
+// Set by hugeUninitializedScope on the constructing thread: elements a
+// hugeAllocator constructs without a value are then left uninitialized
+inline bool& hugeSkipInit() {
+  static thread_local bool skip = false;
+  return skip;
+}
+
+// While in scope, vector(n) with a hugeAllocator leaves its pages
+// untouched, so that the caller can first touch them with a parallel
+// fill. Outside of it elements are value-initialized as usual.
+struct hugeUninitializedScope {
+  hugeUninitializedScope() { hugeSkipInit() = true; }
+  ~hugeUninitializedScope() { hugeSkipInit() = false; }
+};
+
+// STL allocator for vertex-indexed vectors (colors and the like)
+template <class T>
+struct hugeAllocator {
+  typedef T value_type;
+  hugeAllocator() {}
+  template <class U> hugeAllocator(const hugeAllocator<U>&) {}
+  T* allocate(size_t n) {
+    T* p = (T*) hugeAlloc(n * sizeof(T));
+    if (p == NULL) throw bad_alloc();
+    return p;
+  }
+  void deallocate(T* p, size_t) { hugeFree(p); }
+  template <class U> void construct(U* p) {
+    if (hugeSkipInit()) ::new((void*) p) U;
+    else ::new((void*) p) U(); }
+  template <class U, class... Args> void construct(U* p, Args&&... args) {
+    ::new((void*) p) U(std::forward<Args>(args)...); }
+};
+
+template <class T, class U>
+bool operator==(const hugeAllocator<T>&, const hugeAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const hugeAllocator<T>&, const hugeAllocator<U>&) { return false; }
+
+// Transparent huge pages currently backing the process, or -1 if unknown
+inline long anonHugePagesKB() {
+  ifstream in("/proc/self/smaps_rollup");
+  string key;
+  long value;
+  while (in >> key) {
+    if (key == "AnonHugePages:" && in >> value) return value;
+    in.ignore(256, '\n');
+  }
+  return -1;
+}
+
+inline void hugePageReport() {
+  if (hugeConfig.mode == HUGE_NONE) return;
+  cout << "Huge pages: ";
+  if (hugeConfig.mode != HUGE_THP)
+    cout << (hugeConfig.explicitBytes >> 20) << " MB on "
+         << (hugeConfig.mode == HUGE_1GB ? "1GB" : "2MB") << " pages ("
+         << hugeConfig.fallbacks << " fallbacks), ";
+  cout << (hugeConfig.advisedBytes >> 20) << " MB advised for THP, "
+       << anonHugePagesKB() / 1024 << " MB backed by THP" << endl;
+}
+
+// Reads -hugepages and -huge-threshold. Called once before the graph is
+// loaded.
+inline void hugePageInit(commandLine& P) {
+  string mode = P.getOptionValue("-hugepages", string("none"));
+  if (mode == "none") hugeConfig.mode = HUGE_NONE;
+  else if (mode == "thp") hugeConfig.mode = HUGE_THP;
+  else if (mode == "2mb") hugeConfig.mode = HUGE_2MB;
+  else if (mode == "1gb") hugeConfig.mode = HUGE_1GB;
+  else {
+    cout << "Unknown huge page mode: " << mode << endl;
+    abort();
+  }
+  hugeConfig.threshold = P.getOptionLongValue("-huge-threshold", 8) << 20;
+}
+#endif
@@ -24,12 +24,18 @@
 #ifndef _PARALLEL_H
 #define _PARALLEL_H
 
-#if defined(CILK)
+// Loops are written as parallel_for(start, end, f), calling f(i) for every
+// i in [start, end). parallel_for takes an optional granularity: the number
+// of consecutive iterations a worker runs before the range is split again
+// (0 lets the backend choose). parallel_for_1 and parallel_for_256 are the
+// granularity 1 and 256 variants. par_do(left, right) runs two functions in
+// parallel and returns when both are done.
+
+#include <algorithm>
+
+#if defined(CILK) || defined(CILKP)
 #include <cilk/cilk.h>
 #define parallel_main main
-#define parallel_for cilk_for
-#define parallel_for_1 _Pragma("cilk_grainsize = 1") cilk_for
-#define parallel_for_256 _Pragma("cilk_grainsize = 256") cilk_for
 #include <cilk/cilk_api.h>
 #include <sstream>
 #include <iostream>
@@ -37,6 +43,9 @@
 static int getWorkers() {
   return __cilkrts_get_nworkers();
 }
+static int getWorkerNum() {
+  return __cilkrts_get_worker_number();
+}
 static void setWorkers(int n) {
   __cilkrts_end_cilk();
   //__cilkrts_init();
@@ -47,56 +56,108 @@ static void setWorkers(int n) {
   }
 }
 
-// intel cilk+
-#elif defined(CILKP)
-#include <cilk/cilk.h>
-#define parallel_for cilk_for
-#define parallel_main main
-#define parallel_for_1 _Pragma("cilk grainsize = 1") cilk_for
-#define parallel_for_256 _Pragma("cilk grainsize = 256") cilk_for
-#include <cilk/cilk_api.h>
-#include <sstream>
-#include <iostream>
-#include <cstdlib>
-static int getWorkers() {
-  return __cilkrts_get_nworkers();
-}
-static void setWorkers(int n) {
-  __cilkrts_end_cilk();
-  //__cilkrts_init();
-  std::stringstream ss; ss << n;
-  if (0 != __cilkrts_set_param("nworkers", ss.str().c_str())) {
-    std::cerr << "failed to set worker count!" << std::endl;
-    std::abort();
+template <class F>
+inline void parallel_for(long start, long end, F f, long granularity = 0) {
+  if (granularity == 0) {
+    cilk_for (long i = start; i < end; i++) f(i);
+    return;
+  }
+  long blocks = (end - start + granularity - 1) / granularity;
+#if defined(CILK)
+  _Pragma("cilk_grainsize = 1") cilk_for (long b = 0; b < blocks; b++) {
+#else
+  _Pragma("cilk grainsize = 1") cilk_for (long b = 0; b < blocks; b++) {
+#endif
+    long e = std::min(end, start + (b + 1) * granularity);
+    for (long i = start + b * granularity; i < e; i++) f(i);
   }
 }
 
+template <class L, class R>
+inline void par_do(L left, R right) {
+  cilk_spawn left();
+  right();
+  cilk_sync;
+}
+
 // openmp
 #elif defined(OPENMP)
 #include <omp.h>
 #define cilk_spawn
 #define cilk_sync
 #define parallel_main main
-#define parallel_for _Pragma("omp parallel for") for
-#define parallel_for_1 _Pragma("omp parallel for schedule (static,1)") for
-#define parallel_for_256 _Pragma("omp parallel for schedule (static,256)") for
 static int getWorkers() { return omp_get_max_threads(); }
+static int getWorkerNum() { return omp_get_thread_num(); }
 static void setWorkers(int n) { omp_set_num_threads(n); }
 
+template <class F>
+inline void parallel_for(long start, long end, F f, long granularity = 0) {
+  if (granularity == 0) {
+    _Pragma("omp parallel for") for (long i = start; i < end; i++) f(i);
+  } else {
+    _Pragma("omp parallel for schedule (static,granularity)")
+    for (long i = start; i < end; i++) f(i);
+  }
+}
+
+template <class L, class R>
+inline void par_do(L left, R right) { left(); right(); }
+
+// native work-stealing scheduler
+#elif defined(HOMEGROWN)
+#include "scheduler.h"
+#define cilk_spawn
+#define cilk_sync
+#define parallel_main main
+static int getWorkers() { return homegrown::instance()->workers(); }
+static int getWorkerNum() { return homegrown::instance()->workerId(); }
+static void setWorkers(int n) {
+  delete homegrown::instance();
+  homegrown::instance() = new homegrown::scheduler(n);
+}
+
+template <class F>
+inline void parallel_for(long start, long end, F f, long granularity = 0) {
+  if (end <= start) return;
+  if (granularity == 0)
+    granularity = std::max(1L, std::min(2048L, (end - start) / (8L * getWorkers())));
+  homegrown::parallelForRange(start, end, f, granularity);
+}
+
+template <class L, class R>
+inline void par_do(L left, R right) {
+  homegrown::instance()->parDo(left, right);
+}
+
 // c++
 #else
 #define cilk_spawn
 #define cilk_sync
 #define parallel_main main
-#define parallel_for for
-#define parallel_for_1 for
-#define parallel_for_256 for
-#define cilk_for for
 static int getWorkers() { return 1; }
+static int getWorkerNum() { return 0; }
 static void setWorkers(int n) { }
 
+template <class F>
+inline void parallel_for(long start, long end, F f, long granularity = 0) {
+  for (long i = start; i < end; i++) f(i);
+}
+
+template <class L, class R>
+inline void par_do(L left, R right) { left(); right(); }
+
 #endif
 
+template <class F>
+inline void parallel_for_1(long start, long end, F f) {
+  parallel_for(start, end, f, 1);
+}
+
+template <class F>
+inline void parallel_for_256(long start, long end, F f) {
+  parallel_for(start, end, f, 256);
+}
+
 #include <limits.h>
 
 #if defined(LONG)
@@ -0,0 +1,167 @@
+#ifndef REVERSE_EDGES_H
+#define REVERSE_EDGES_H
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <stdlib.h>
+#include "parallel.h"
+#include "utils.h"
+#include "binary_search.h"
+#include "blockRadixSort.h"
+#include "index_map.h"
+#include "parseCommandLine.h"
+#include "graph.h"
+using namespace std;
+
+// **************************************************************
+//    REVERSE EDGE INDEX OF SYMMETRIC GRAPHS
+// **************************************************************
+//
+// Edges are numbered in CSR order: the j-th out-edge of vertex i is edge
+// offsets[i]+j, with offsets the prefix sums of the out-degrees. For every
+// edge e = (u,v), rev[e] is the number of the edge (v,u). Self-loops are
+// their own reverse.
+
+// Returns the n+1 CSR offsets of GA's out-edges.
+template <class vertex>
+uintT* edgeOffsets(graph<vertex>& GA) {
+  long n = GA.n;
+  uintT* offsets = newA(uintT, n+1);
+  {parallel_for(0, n, [&] (long i) { offsets[i] = GA.V[i].getOutDegree(); });}
+  offsets[n] = sequence::plusScan(offsets, offsets, n);
+  return offsets;
+}
+
+// When every adjacency list is sorted, the reverse of (u,v) is found by
+// binary search for u in the list of v.
+template <class vertex>
+void reverseEdgesSorted(graph<vertex>& GA, uintT* offsets, uintT* rev) {
+  long n = GA.n;
+  auto lt = [] (const uintE& l, const uintE& r) { return l < r; };
+  parallel_for(0, n, [&] (long i) {
+    uintT d = GA.V[i].getOutDegree();
+    for(uintT j=0;j<d;j++) {
+      uintE ngh = GA.V[i].getOutNeighbor(j);
+      auto nghList = make_in_imap<uintE>(GA.V[ngh].getOutDegree(),
+        [&] (size_t k) { return (uintE) GA.V[ngh].getOutNeighbor(k); });
+      uintT k = pbbs::binary_search(nghList, (uintE) i, lt);
+      bool found = k < GA.V[ngh].getOutDegree() && GA.V[ngh].getOutNeighbor(k) == (uintE) i;
+      rev[offsets[i]+j] = found ? offsets[ngh] + k : UINT_T_MAX;
+    }
+  });
+}
+
+// Otherwise the edges are radix sorted on their smaller endpoint, which
+// puts every edge and its reverse in the same group, then each group is
+// sorted on the larger endpoint, forward direction (u < v) before
+// backward. The radix key stays below n, and a group holds at most twice
+// the degree of its vertex. Duplicate edges are paired up in order.
+template <class vertex>
+void reverseEdgesRadix(graph<vertex>& GA, uintT* offsets, uintT* rev) {
+  long n = GA.n, m = offsets[n];
+  uintE* src = newA(uintE, m);
+  uintE* dst = newA(uintE, m);
+  uintT* ids = newA(uintT, m);
+  {parallel_for(0, n, [&] (long i) {
+    uintT d = GA.V[i].getOutDegree();
+    for(uintT j=0;j<d;j++) {
+      src[offsets[i]+j] = i;
+      dst[offsets[i]+j] = GA.V[i].getOutNeighbor(j);
+      ids[offsets[i]+j] = offsets[i]+j;
+    }
+  });}
+  uintT* groups = newA(uintT, n+1);
+  if (m > 0) intSort::iSort(ids, groups, m, n,
+    [&] (uintT e) { return min(src[e], dst[e]); });
+  else {parallel_for(0, n, [&] (long i) { groups[i] = 0; });}
+  groups[n] = m;
+
+  auto other = [&] (uintT e) { return max(src[e], dst[e]); };
+  auto backward = [&] (uintT e) { return src[e] > dst[e]; };
+  {parallel_for(0, n, [&] (long g) {
+    uintT* group = ids + groups[g];
+    long size = groups[g+1] - groups[g];
+    sort(group, group + size, [&] (uintT l, uintT r) {
+      if (other(l) != other(r)) return other(l) < other(r);
+      if (backward(l) != backward(r)) return backward(r);
+      return l < r; });
+    for(long i=0;i<size;) {
+      long end = i+1;
+      while (end < size && other(group[end]) == other(group[i])) end++;
+      long forward = i;
+      while (forward < end && !backward(group[forward])) forward++;
+      if (src[group[i]] == dst[group[i]]) {
+        for(long k=i;k<end;k++) rev[group[k]] = group[k];
+      } else {
+        // forward edges are [i, forward), backward ones [forward, end)
+        long pairs = min(forward - i, end - forward);
+        for(long k=0;k<pairs;k++) {
+          rev[group[i+k]] = group[forward+k];
+          rev[group[forward+k]] = group[i+k];
+        }
+        for(long k=i+pairs;k<forward;k++) rev[group[k]] = UINT_T_MAX;
+        for(long k=forward+pairs;k<end;k++) rev[group[k]] = UINT_T_MAX;
+      }
+      i = end;
+    }
+  });}
+  free(src); free(dst); free(ids); free(groups);
+}
+
+// Computes rev for a symmetric graph. Edges without a reverse mean the
+// graph is not symmetric, which is reported before exiting.
+template <class vertex>
+uintT* reverseEdges(graph<vertex>& GA, uintT* offsets) {
+  long n = GA.n;
+  uintT* rev = newA(uintT, offsets[n]);
+  bool sorted = sequence::reduce<bool>((long) 0, n,
+    [] (bool a, bool b) { return a && b; },
+    [&] (long i) {
+      uintT d = GA.V[i].getOutDegree();
+      for(uintT j=1;j<d;j++)
+        if (GA.V[i].getOutNeighbor(j-1) > GA.V[i].getOutNeighbor(j)) return false;
+      return true; });
+  if (sorted) reverseEdgesSorted(GA, offsets, rev);
+  else reverseEdgesRadix(GA, offsets, rev);
+  long unpaired = sequence::reduce<long>((long) 0, (long) offsets[n], addF<long>(),
+    [&] (long e) -> long { return rev[e] == UINT_T_MAX; });
+  if (unpaired > 0) {
+    cout << "Reverse edges: " << unpaired << " edges have no reverse, "
+         << "the graph is not symmetric. Exiting..." << endl;
+    exit(2);
+  }
+  return rev;
+}
+
+// Binary graphs can keep the index in a <file>.rev next to the .adj and
+// .idx files, as m uintT values. It is read if present and of the right
+// size, and otherwise computed and, with -save-rev, written.
+template <class vertex>
+uintT* reverseEdges(graph<vertex>& GA, uintT* offsets, commandLine& P) {
+  long m = offsets[GA.n];
+  string revFile = string(P.getArgument(0)) + ".rev";
+  bool binary = P.getOption("-b");
+  if (binary) {
+    ifstream in(revFile.c_str(), ifstream::in | ios::binary);
+    if (in.is_open()) {
+      in.seekg(0, ios::end);
+      long size = in.tellg();
+      in.seekg(0);
+      if (size == m * (long) sizeof(uintT)) {
+        uintT* rev = newA(uintT, m);
+        in.read((char*) rev, size);
+        return rev;
+      }
+      cout << "Ignoring " << revFile << ": wrong size" << endl;
+    }
+  }
+  uintT* rev = reverseEdges(GA, offsets);
+  if (binary && P.getOption("-save-rev")) {
+    ofstream out(revFile.c_str(), ofstream::out | ios::binary);
+    out.write((char*) rev, m * sizeof(uintT));
+    if (!out) cout << "Unable to write " << revFile << endl;
+  }
+  return rev;
+}
+#endif
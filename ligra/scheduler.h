@@ -0,0 +1,228 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstdlib>
+
+// **************************************************************
+//    WORK-STEALING SCHEDULER (HOMEGROWN)
+// **************************************************************
+//
+// A fork-join scheduler on plain std::thread workers, so the framework
+// builds without Cilk Plus or OpenMP. Every worker owns a Chase-Lev deque:
+// forked jobs are pushed and popped at the bottom by the owner and stolen
+// from the top by idle workers. The thread calling into the scheduler
+// (the main thread) is worker 0 and works like the others while it waits
+// for a join. The worker count is read from NUM_THREADS, defaulting to the
+// number of hardware threads, and can be changed with setWorkers.
+
+namespace homegrown {
+
+// Called on every worker thread, worker 0 included, with its id and the
+// worker count before the thread takes any job (e.g. to pin it to a NUMA
+// node). A scheduler only returns from its constructor once all its
+// workers have run it.
+inline std::function<void(int, int)>& workerStartHook() {
+  static std::function<void(int, int)> hook;
+  return hook;
+}
+
+struct job {
+  std::atomic<bool> done;
+  job() : done(false) {}
+  virtual void execute() = 0;
+  virtual ~job() {}
+};
+
+template <class F>
+struct fnJob : public job {
+  F& f;
+  fnJob(F& _f) : f(_f) {}
+  void execute() { f(); done.store(true, std::memory_order_release); }
+};
+
+// Chase-Lev deque of fixed capacity ("Correct and Efficient Work-Stealing
+// for Weak Memory Models", Le et al. 2013). push fails when full, in which
+// case the caller runs the job itself.
+class deque {
+  static const long capacity = 1 << 13;
+  std::atomic<long> top, bottom;
+  std::atomic<job*> buffer[capacity];
+public:
+  deque() : top(0), bottom(0) {}
+
+  bool push(job* j) {
+    long b = bottom.load(std::memory_order_relaxed);
+    long t = top.load(std::memory_order_acquire);
+    if (b - t >= capacity) return false;
+    buffer[b % capacity].store(j, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  job* pop() {
+    long b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return NULL;
+    }
+    job* j = buffer[b % capacity].load(std::memory_order_relaxed);
+    if (t == b) {
+      // last job, race against thieves
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+        j = NULL;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return j;
+  }
+
+  job* steal() {
+    long t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return NULL;
+    job* j = buffer[t % capacity].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+      return NULL;
+    return j;
+  }
+};
+
+class scheduler {
+  int numWorkers;
+  deque* deques;
+  std::vector<std::thread> threads;
+  std::atomic<bool> stopping;
+  // parallel regions entered from outside the workers; workers sleep when
+  // there are none
+  std::atomic<int> activeRegions;
+  std::atomic<int> startedWorkers;
+  std::mutex sleepLock;
+  std::condition_variable wake;
+
+  static int& threadId() {
+    static thread_local int id = 0;
+    return id;
+  }
+
+  job* findJob(int id, unsigned& seed) {
+    job* j = deques[id].pop();
+    if (j) return j;
+    seed = seed * 1103515245 + 12345;
+    int victim = (seed >> 16) % numWorkers;
+    if (victim == id) return NULL;
+    return deques[victim].steal();
+  }
+
+  void workerLoop(int id) {
+    threadId() = id;
+    if (workerStartHook()) workerStartHook()(id, numWorkers);
+    startedWorkers++;
+    unsigned seed = id * 7919 + 1;
+    int idle = 0;
+    while (!stopping.load(std::memory_order_acquire)) {
+      job* j = findJob(id, seed);
+      if (j) { j->execute(); idle = 0; continue; }
+      if (++idle < 1024) { std::this_thread::yield(); continue; }
+      std::unique_lock<std::mutex> lock(sleepLock);
+      wake.wait(lock, [&] {
+        return stopping.load() || activeRegions.load() > 0; });
+      idle = 0;
+    }
+  }
+
+  // Runs other jobs until j is done
+  void waitFor(job& j) {
+    int id = threadId();
+    unsigned seed = id * 7919 + 1;
+    while (!j.done.load(std::memory_order_acquire)) {
+      job* other = findJob(id, seed);
+      if (other) other->execute();
+      else std::this_thread::yield();
+    }
+  }
+
+public:
+  scheduler(int p) : numWorkers(std::max(p, 1)), stopping(false),
+                     activeRegions(0), startedWorkers(1) {
+    deques = new deque[numWorkers];
+    for (int i = 1; i < numWorkers; i++)
+      threads.push_back(std::thread([this, i] { workerLoop(i); }));
+    if (workerStartHook()) workerStartHook()(0, numWorkers);
+    while (startedWorkers.load() < numWorkers) std::this_thread::yield();
+  }
+
+  ~scheduler() {
+    {
+      std::lock_guard<std::mutex> lock(sleepLock);
+      stopping.store(true);
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    delete[] deques;
+  }
+
+  int workers() { return numWorkers; }
+  int workerId() { return threadId(); }
+
+  template <class L, class R>
+  void parDo(L& left, R& right) {
+    // regions started by the main thread wake the sleeping workers
+    bool outer = (threadId() == 0 && activeRegions.load() == 0);
+    if (outer) {
+      std::lock_guard<std::mutex> lock(sleepLock);
+      activeRegions++;
+      wake.notify_all();
+    }
+    fnJob<R> rightJob(right);
+    int id = threadId();
+    if (!deques[id].push(&rightJob)) {
+      left(); right();
+    } else {
+      left();
+      if (deques[id].pop() == &rightJob) right();
+      else waitFor(rightJob);
+    }
+    if (outer) activeRegions--;
+  }
+};
+
+inline int defaultWorkers() {
+  const char* env = getenv("NUM_THREADS");
+  if (env && atoi(env) > 0) return atoi(env);
+  return std::max(1, (int) std::thread::hardware_concurrency());
+}
+
+inline scheduler*& instance() {
+  static scheduler* s = NULL;
+  if (s == NULL) s = new scheduler(defaultWorkers());
+  return s;
+}
+
+// Splits [start, end) in halves until ranges have at most granularity
+// iterations
+template <class F>
+void parallelForRange(long start, long end, F& f, long granularity) {
+  if (end - start <= granularity) {
+    for (long i = start; i < end; i++) f(i);
+    return;
+  }
+  long mid = start + (end - start) / 2;
+  auto left = [&] { parallelForRange(start, mid, f, granularity); };
+  auto right = [&] { parallelForRange(mid, end, f, granularity); };
+  instance()->parDo(left, right);
+}
+
+}  // namespace homegrown
+#endif
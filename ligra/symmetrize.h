@@ -0,0 +1,97 @@
+#ifndef SYMMETRIZE_H
+#define SYMMETRIZE_H
+#include <iostream>
+#include <stdlib.h>
+#include <algorithm>
+#include "parallel.h"
+#include "utils.h"
+#include "blockRadixSort.h"
+#include "graph.h"
+using namespace std;
+
+// **************************************************************
+//    IN-MEMORY SYMMETRIZATION
+// **************************************************************
+
+typedef pair<uintE,uintE> edgePair;
+
+// Returns the undirected closure of GA as a symmetric graph: every
+// out-edge (u,v) contributes both (u,v) and (v,u). The pairs are radix
+// sorted on their source, then sorted by target within each source. This
+// groups duplicates next to each other so that they and self-loops can
+// be dropped with a single pack.
+// Only unweighted graphs are supported.
+template <class vertex>
+graph<symmetricVertex> symmetrizeGraph(graph<vertex>& GA) {
+  long n = GA.n;
+  vertex* G = GA.V;
+
+  uintT* offsets = newA(uintT, n);
+  {parallel_for(0, n, [&] (long i) { offsets[i] = G[i].getOutDegree(); });}
+  long m = sequence::plusScan(offsets, offsets, n);
+
+  edgePair* pairs = newA(edgePair, 2*m);
+  {parallel_for(0, n, [&] (long i) {
+    uintT o = offsets[i];
+    uintT d = G[i].getOutDegree();
+    for(uintT j=0;j<d;j++) {
+      uintE ngh = G[i].getOutNeighbor(j);
+      pairs[2*(o+j)] = make_pair((uintE) i, ngh);
+      pairs[2*(o+j)+1] = make_pair(ngh, (uintE) i);
+    }
+  });}
+  free(offsets);
+
+  // Radix sort on the source, a key below n, then sort every source's
+  // targets on their own
+  uintT* sources = newA(uintT, n+1);
+  if (m > 0) intSort::iSort(pairs, sources, 2*m, n,
+    [] (edgePair p) { return p.first; });
+  else {parallel_for(0, n, [&] (long i) { sources[i] = 0; });}
+  sources[n] = 2*m;
+  {parallel_for(0, n, [&] (long i) {
+    sort(pairs + sources[i], pairs + sources[i+1]);
+  });}
+  free(sources);
+
+  bool* keep = newA(bool, 2*m);
+  {parallel_for(0, 2*m, [&] (long i) {
+    keep[i] = (pairs[i].first != pairs[i].second) &&
+      (i == 0 || pairs[i] != pairs[i-1]);
+  });}
+  edgePair* packed = newA(edgePair, 2*m);
+  long newM = sequence::pack(pairs, packed, keep, 2*m);
+  free(keep); free(pairs);
+
+  uintT* tOffsets = newA(uintT, n);
+  uintE* edges = newHugeA(uintE, newM);
+  {parallel_for(0, n, [&] (long i) { tOffsets[i] = (newM == 0) ? 0 : INT_T_MAX; });}
+  if (newM > 0) tOffsets[packed[0].first] = 0;
+  {parallel_for(0, newM, [&] (long i) {
+    edges[i] = packed[i].second;
+    if(i > 0 && packed[i].first != packed[i-1].first) {
+      tOffsets[packed[i].first] = i;
+    }
+  });}
+  free(packed);
+
+  //fill in offsets of degree 0 vertices by taking closest non-zero
+  //offset to the right
+  sequence::scanIBack(tOffsets,tOffsets,n,minF<uintT>(),(uintT)newM);
+
+  symmetricVertex* v = newHugeA(symmetricVertex, n);
+  {parallel_for(0, n, [&] (long i) {
+    uintT o = tOffsets[i];
+    uintT l = ((i == n-1) ? newM : tOffsets[i+1])-tOffsets[i];
+    v[i].setOutDegree(l);
+    v[i].setOutNeighbors(edges+o);
+  });}
+  free(tOffsets);
+
+  cout << "Symmetrized directed graph: " << m << " edges -> " << newM
+       << " undirected edges" << endl;
+  Uncompressed_Mem<symmetricVertex>* mem =
+    new Uncompressed_Mem<symmetricVertex>(v,n,newM,edges);
+  return graph<symmetricVertex>(v,n,newM,mem);
+}
+#endif
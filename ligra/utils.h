@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <rwlock.hpp>
 #include "parallel.h"
+#include "pageAlloc.h"
 using namespace std;
 
 // Needed to make frequent large allocations efficient with standard
@@ -43,7 +44,9 @@ static int __jj =  mallopt(M_TRIM_THRESHOLD,-1);
 typedef unsigned int uint;
 typedef unsigned long ulong;
 
-#define newA(__E,__n) (__E*) malloc((__n)*sizeof(__E))
+#define newA(__E,__n) (__E*) pageAlloc((__n)*sizeof(__E))
+// for arrays released with hugeFree, which may be on explicit huge pages
+#define newHugeA(__E,__n) (__E*) hugeAlloc((__n)*sizeof(__E))
 
 template <class E>
 struct identityF { E operator() (const E& x) {return x;}};
@@ -117,11 +120,11 @@ namespace sequence {
     intT _ee = _e;					\
     intT _n = _ee-_ss;					\
     intT _l = nblocks(_n,_bsize);			\
-    parallel_for (intT _i = 0; _i < _l; _i++) {		\
+    parallel_for (0, _l, [&] (intT _i) {		\
       intT _s = _ss + _i * (_bsize);			\
       intT _e = min(_s + (_bsize), _ee);		\
       _body						\
-	}						\
+	});						\
   }
 
   template <class OT, class intT, class F, class G>
@@ -287,7 +290,7 @@ namespace sequence {
 
   template <class ET, class intT, class PRED>
   intT filter(ET* In, ET* Out, bool* Fl, intT n, PRED p) {
-    parallel_for (intT i=0; i < n; i++) Fl[i] = (bool) p(In[i]);
+    parallel_for (0, n, [&] (intT i) { Fl[i] = (bool) p(In[i]); });
     intT  m = pack(In, Out, Fl, n);
     return m;
   }
@@ -358,14 +361,14 @@ inline ulong hashInt(ulong a) {
 // UINT_E_MAX.
 template <class G>
 void remDuplicates(G& get_key, uintE* flags, long m, long n) {
-  parallel_for(size_t i=0; i<m; i++) {
+  parallel_for(0, m, [&] (size_t i) {
     uintE key = get_key(i);
     if(key != UINT_E_MAX && flags[key] == UINT_E_MAX) {
       CAS(&flags[key],(uintE)UINT_E_MAX,static_cast<uintE>(i));
     }
-  }
+  });
   //reset flags
-  parallel_for(size_t i=0; i<m; i++) {
+  parallel_for(0, m, [&] (size_t i) {
     uintE key = get_key(i);
     if(key != UINT_E_MAX) {
     	if(flags[key] == i) { //win
@@ -374,14 +377,14 @@ void remDuplicates(G& get_key, uintE* flags, long m, long n) {
         get_key(i) = UINT_E_MAX; //lost
       }
     }
-  }
+  });
 }
 
 #define granular_for(_i, _start, _end, _cond, _body) { \
   if (_cond) { \
-    {parallel_for(size_t _i=_start; _i < _end; _i++) { \
+    {parallel_for(_start, _end, [&] (size_t _i) { \
       _body \
-    }} \
+    });} \
   } else { \
     {for (size_t _i=_start; _i < _end; _i++) { \
       _body \
@@ -451,8 +454,8 @@ namespace pbbs {
     if (r == NULL) {fprintf(stderr, "Cannot allocate space"); exit(1);}
     // a hack to make sure tlb is full for huge pages
     if (touch_pages)
-      parallel_for (size_t i = 0; i < bytes; i = i + (1 << 21))
-	((bool*) r)[i] = 0;
+      parallel_for (0, (bytes + (1 << 21) - 1) >> 21, [&] (size_t i) {
+	((bool*) r)[i << 21] = 0; });
     return r;
   }
 
@@ -462,7 +465,7 @@ namespace pbbs {
     E* r = new_array_no_init<E>(n);
     if (!std::is_trivially_default_constructible<E>::value) {
       if (n > 2048)
-	parallel_for (size_t i = 0; i < n; i++) new ((void*) (r+i)) E;
+	parallel_for (0, n, [&] (size_t i) { new ((void*) (r+i)) E; });
       else
 	for (size_t i = 0; i < n; i++) new ((void*) (r+i)) E;
     }
@@ -475,7 +478,7 @@ namespace pbbs {
     // C++14 -- suppored by gnu C++11
     if (!std::is_trivially_destructible<E>::value) {
       if (n > 2048)
-	parallel_for (size_t i = 0; i < n; i++) A[i].~E();
+	parallel_for (0, n, [&] (size_t i) { A[i].~E(); });
       else
 	for (size_t i = 0; i < n; i++) A[i].~E();
     }
@@ -26,7 +26,7 @@ namespace decode_uncompressed {
         if(!f.cond(v_id)) break;
       }
     } else {
-      parallel_for(size_t j=0; j<d; j++) {
+      parallel_for(0, d, [&] (size_t j) {
         uintE ngh = v->getInNeighbor(j);
         if (vertexSubset.isIn(ngh)) {
 #ifndef WEIGHTED
@@ -36,7 +36,7 @@ namespace decode_uncompressed {
 #endif
           g(v_id, m);
         }
-      }
+      });
     }
   }
 
@@ -120,7 +120,7 @@ namespace decode_uncompressed {
       size_t b_size = 2000;
       size_t blocks = 1 + ((d-1)/b_size);
       auto cts = array_imap<uintE>(blocks, [&] (size_t i) { return 0; });
-      parallel_for_1(size_t i=0; i<blocks; i++) {
+      parallel_for_1(0, blocks, [&] (size_t i) {
         size_t s = b_size*i;
         size_t e = std::min(s + b_size, (size_t)d);
         uintE ct = 0;
@@ -134,7 +134,7 @@ namespace decode_uncompressed {
             ct++;
         }
         cts[i] = ct;
-      }
+      });
       size_t count = 0;
       return pbbs::reduce_add(cts);
     }
@@ -172,11 +172,11 @@ namespace decode_uncompressed {
       v->setOutDegree(k);
       return k;
     } else {
-      parallel_for(size_t i=0; i<d; i++) {
+      parallel_for(0, d, [&] (size_t i) {
         uintE ngh = v->getOutNeighbor(i);
         tmp[i] = ngh;
         bits[i] = p(vtx_id, ngh);
-      }
+      });
       size_t k = sequence::pack(tmp, v->getOutNeighbors(), bits, d);
       v->setOutDegree(k);
       return k;
@@ -0,0 +1,57 @@
+#!/bin/bash
+# Sweep coloring engines x graphs x worker counts and collect the results
+# of the -bench driver into a single CSV file.
+#
+# usage: scripts/bench_sweep.sh -e "asynch_lockfree asynch_naive" \
+#            -g "graphs/a.adj graphs/b.adj" [-w 1,2,4,8] [-n trials]
+#            [-m warmups] [-o results.csv] [-- extra engine flags]
+#
+# Engine output is kept in <csv>.log; only the summaries are printed.
+
+engines=""
+graphs=""
+workers=""
+trials=5
+warmup=1
+out="bench_results.csv"
+bindir="$(dirname "$0")/../bin"
+
+while getopts "e:g:w:n:m:o:b:" opt; do
+  case $opt in
+    e) engines="$OPTARG" ;;
+    g) graphs="$OPTARG" ;;
+    w) workers="$OPTARG" ;;
+    n) trials="$OPTARG" ;;
+    m) warmup="$OPTARG" ;;
+    o) out="$OPTARG" ;;
+    b) bindir="$OPTARG" ;;
+    *) sed -n '2,10p' "$0"; exit 1 ;;
+  esac
+done
+shift $((OPTIND - 1))
+[ "$1" = "--" ] && shift
+
+if [ -z "$engines" ] || [ -z "$graphs" ]; then
+  sed -n '2,10p' "$0"
+  exit 1
+fi
+
+workerFlag=""
+[ -n "$workers" ] && workerFlag="-workers $workers"
+
+for engine in $engines; do
+  if [ ! -x "$bindir/$engine" ]; then
+    echo "missing binary $bindir/$engine (run make $engine)" >&2
+    exit 1
+  fi
+  for graph in $graphs; do
+    log=$("$bindir/$engine" -bench $workerFlag -warmup "$warmup" \
+      -rounds "$trials" -csv "$out" "$@" "$graph" 2>&1)
+    status=$?
+    echo "$log" >> "$out.log"
+    echo "$log" | grep "^Benchmark " | sed "s|^|$(basename "$graph"): |"
+    if [ $status -ne 0 ]; then
+      echo "$engine failed on $graph (exit $status), see $out.log" >&2
+    fi
+  done
+done
@@ -0,0 +1,208 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "coloring_base.h"
+
+// Size in bytes of the last level cache, from -llc-kb or sysfs
+inline size_t getLLCBytes(commandLine &P)
+{
+    long llcKB = P.getOptionLongValue("-llc-kb", 0);
+    for (int index = 3; llcKB <= 0 && index >= 2; index--)
+    {
+        std::stringstream ss;
+        ss << "/sys/devices/system/cpu/cpu0/cache/index" << index << "/size";
+        ifstream in(ss.str().c_str());
+        std::string size;
+        if (in >> size)
+        {
+            llcKB = atol(size.c_str());
+            if (!size.empty() && size[size.size() - 1] == 'M')
+                llcKB *= 1024;
+        }
+    }
+    return (llcKB > 0 ? llcKB : 8192) * 1024;
+}
+
+// Cache-blocked coloring implementation. The vertex range is split into
+// blocks whose colors fit in a worker's share of the LLC. Each block is
+// first colored on its own, considering only edges inside the block, so
+// color reads stay in cache; vertices with mostly internal neighbours are
+// colored before the others. Vertices with cross-block edges are then
+// rescheduled and fixed like in the naive engine.
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer, iterTimer;
+    fullTimer.start();
+    
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+    
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
+
+    // Blocks hold half of a worker's share of the LLC worth of colors
+    size_t blockSize = P.getOptionLongValue("-block-size", 0);
+    if (blockSize == 0)
+        blockSize = std::max((size_t) 1024, getLLCBytes(P) / getWorkers() / (2 * sizeof(uintT)));
+    const size_t numBlocks = (numVertices + blockSize - 1) / blockSize;
+
+    // Verbose variables
+    bool verbose = true;
+    uintT activeVertices;
+    uintT activeEdges;
+    uintT changedVertices;
+
+    BitsetScheduler currentSchedule(numVertices);
+    currentSchedule.reset();
+
+    // Vertices with at least this many neighbours are colored with nested
+    // parallelism (-hub-degree)
+    const uintT hubDegree = P.getOptionLongValue("-hub-degree", HUB_DEGREE_DEFAULT);
+
+    // Per-worker forbidden color sets for the first-fit search
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
+
+    double lastStopTime = iterTimer.getTime();
+
+    // Color every block independently. Vertices with cross-block edges are
+    // scheduled for the resolution phase.
+    uintT crossVertices = 0;
+    uintT crossEdges = 0;
+    parallel_for_1 (0, numBlocks, [&] (size_t b_i)
+    {
+        const uintT blockStart = b_i * blockSize;
+        const uintT blockEnd = std::min(numVertices, (b_i + 1) * blockSize);
+        ForbiddenColors &forbiddenColors = workerColors.local();
+
+        // Pass 0 takes vertices with at least half of their neighbours in
+        // the block, pass 1 the others
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (uintT v_i = blockStart; v_i < blockEnd; v_i++)
+            {
+                const uintT vDegree = GA.V[v_i].getOutDegree();
+                uintT internal = 0;
+                for (uintT n_i = 0; n_i < vDegree; n_i++)
+                {
+                    uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+                    if (neigh >= blockStart && neigh < blockEnd)
+                        internal++;
+                }
+                if ((pass == 0) != (2 * internal >= vDegree))
+                    continue;
+
+                // Uncolored neighbours are UINT_T_MAX and ignored by mark
+                forbiddenColors.reset(vDegree);
+                for (uintT n_i = 0; n_i < vDegree; n_i++)
+                {
+                    uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+                    if (neigh >= blockStart && neigh < blockEnd)
+                        forbiddenColors.mark(colorData[neigh]);
+                }
+                colorData[v_i] = forbiddenColors.firstFree();
+
+                if (internal != vDegree)
+                {
+                    currentSchedule.schedule(v_i, false);
+                    writeAdd(&crossVertices, (uintT) 1);
+                    writeAdd(&crossEdges, vDegree - internal);
+                }
+            }
+        }
+    });
+
+    if (verbose)
+    {
+        std::cout << std::endl;
+        std::cout << "Blocked phase: " << numBlocks << " blocks of " << blockSize << " vertices" << std::endl;
+        std::cout << "\tCross-block Vs: " << crossVertices << std::endl;
+        std::cout << "\tCross-block Es: " << crossEdges << std::endl;
+        std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+        lastStopTime = iterTimer.getTime();
+    }
+
+    // Resolve cross-block edges until nothing is scheduled
+    uint64_t iter = 0;
+    while (currentSchedule.anyScheduledTasks())
+    {
+        iter++;
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << iter << std::endl;
+        }
+        activeVertices = 0;
+        activeEdges = 0;
+        changedVertices = 0;
+
+        currentSchedule.newIteration();
+        activeVertices = currentSchedule.numTasks();
+
+        vertexLoop.run([&] (uintT v_i)
+        {
+            if (currentSchedule.isScheduled(v_i))
+            {
+                const uintT vDegree = GA.V[v_i].getOutDegree();
+                writeAdd(&activeEdges, vDegree);
+
+                uintT newColor = firstFitColor(GA.V[v_i], colorData, workerColors.local(),
+                                               vDegree, hubDegree);
+                uintT oldColor = colorData[v_i]; 
+                if (newColor <= vDegree && oldColor != newColor)
+                {
+                    colorData[v_i] = newColor;
+                    writeAdd(&changedVertices, (uintT) 1);
+
+                    for (uintT n_i = 0; n_i < vDegree; n_i++)
+                    {
+                        uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+                        if (oldColor < colorData[neigh] || colorData[v_i] == colorData[neigh])
+                            currentSchedule.schedule(neigh, false);
+                    }
+                }
+            }
+        });
+        if (verbose)
+        {
+            std::cout << "\tActive Vs: " << activeVertices << std::endl;
+            std::cout << "\tActive Es: " << activeEdges << std::endl;
+            std::cout << "\tModified Vs: " << changedVertices << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+    }
+    vertexLoop.del();
+    benchCounters.iterations = iter;
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
+}
@@ -33,11 +33,11 @@ void Compute(graph<vertex> &GA, commandLine P)
     fullTimer.start();
 
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
-    std::vector<uintT> colorData(numVertices, maxDegree);
+    colorVector colorData = makeColorVector(numVertices, maxDegree);
     // randomizeColors(GA, colorData);
 
     // Verbose variables
@@ -51,6 +51,12 @@ void Compute(graph<vertex> &GA, commandLine P)
     currentSchedule.reset();
     currentSchedule.scheduleAll();
 
+    // Per-worker forbidden color sets for the first-fit search
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Optional software prefetching K vertices ahead of the loop (-prefetch K)
+    PrefetchPipeline<vertex, colorVector> pipeline(GA, colorData, P.getOptionLongValue("-prefetch", 0));
+
     // Make partition by coloring
     std::vector<std::vector<uintT>> partition(maxDegree + 1);
     uint64_t iter = 1;
@@ -64,6 +70,17 @@ void Compute(graph<vertex> &GA, commandLine P)
 
     changedVertices = makeColorPartition(GA, partition, colorData, maxDegree);
 
+    // The classes do not change, so their edge-balanced blocks are built
+    // once. A hub in a class then no longer leaves one worker the tail.
+    std::vector<edgeBalancedBlocks> classLoops;
+    for (uintT p_i = 0; p_i < partition.size(); p_i++)
+    {
+        classLoops.push_back(edgeBalancedBlocks(partition[p_i].size(), [&] (long pv_i)
+        {
+            return (size_t) GA.V[partition[p_i][pv_i]].getOutDegree() + 1;
+        }));
+    }
+
     std::cout << "\tActive Vs: " << numVertices << std::endl;
     std::cout << "\tActive Es: " << GA.m << std::endl;
     std::cout << "\tModified Vs: " << changedVertices << std::endl;
@@ -96,8 +113,14 @@ void Compute(graph<vertex> &GA, commandLine P)
         {
             uintT numPartVerices = partition[p_i].size();
             // Parallel loop where each vertex is assigned a color
-            parallel_for(uintT pv_i = 0; pv_i < numPartVerices; pv_i++)
+            classLoops[p_i].run([&] (uintT pv_i)
             {
+                pipeline.ahead(pv_i, numPartVerices, [&] (size_t pos) -> uintT
+                {
+                    uintT u_i = partition[p_i][pos];
+                    return currentSchedule.isScheduled(u_i) ? u_i : UINT_T_MAX;
+                });
+
                 uintT v_i = partition[p_i][pv_i];
                 if (currentSchedule.isScheduled(v_i))
                 {
@@ -108,34 +131,21 @@ void Compute(graph<vertex> &GA, commandLine P)
                     
                     activeEdges += vDegree;
 
-                    // Make bool array for possible color values and then set any color
-                    // already taken by neighbours to false
-                    std::vector<bool> possibleColors(maxDegree + 1, true);
+                    // Mark the colors already taken by neighbours
+                    ForbiddenColors &forbiddenColors = workerColors.local();
+                    forbiddenColors.reset(vMaxColor);
                     
-                    for (uintT n_i = 0; n_i < vDegree; n_i++)
-                    {
-                        uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-                        uintT neighVal = colorData[neigh];
-                        possibleColors[neighVal] = false;      
-                    }
+                    markNeighborColors(GA.V[v_i], colorData, forbiddenColors);
 
-                    // Find minimum color by iterating through color array in increasing order
-                    uintT newColor = 0;
+                    // Assign the minimum color not taken by a neighbour if it is
+                    // not the vertex's current value
+                    uintT newColor = forbiddenColors.firstFree();
                     uintT oldColor = colorData[v_i]; 
-                    while (newColor <= vMaxColor)
-                    {                    
-                        // If color is available and it is not the vertex's current value then try to assign
-                        if (possibleColors[newColor])
-                        {
-                            if (newColor != oldColor)
-                            {
-                                colorData[v_i] = newColor;
-                                scheduleNeighbors = true;
-                                changedVertices++;
-                            }
-                            break;
-                        }                        
-                        newColor++;
+                    if (newColor <= vMaxColor && newColor != oldColor)
+                    {
+                        colorData[v_i] = newColor;
+                        scheduleNeighbors = true;
+                        changedVertices++;
                     }
 
                     // Schedule all neighbours if required
@@ -149,7 +159,7 @@ void Compute(graph<vertex> &GA, commandLine P)
                         }
                     }
                 }
-            }
+            });
         }
         if (verbose)
         {
@@ -160,11 +170,14 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    for (uintT p_i = 0; p_i < classLoops.size(); p_i++)
+        classLoops[p_i].del();
+    benchCounters.iterations = iter - 1;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph and cleanup
-    assessGraph(GA, colorData, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
 }
\ No newline at end of file
@@ -33,15 +33,16 @@ void Compute(graph<vertex> &GA, commandLine P)
     fullTimer.start();
 
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
 
     const size_t numVertices = GA.n;
     Color* colorData = new Color[numVertices];
+    numaPlaceVertexArray(colorData, numVertices, sizeof(Color));
     const uintT maxDegree = setDegrees(GA, colorData);
-    for (uintT i = 0; i < numVertices; i++)
+    parallel_for (0, numVertices, [&] (uintT i)
     {
         colorData[i].color = maxDegree;
-    }
+    });
 
     // Verbose variables
     bool verbose = true;
@@ -54,6 +55,9 @@ void Compute(graph<vertex> &GA, commandLine P)
     currentSchedule.reset();
     currentSchedule.scheduleAll();
 
+    // Per-worker forbidden color sets for the first-fit search
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
     double lastStopTime = iterTimer.getTime();
     
     // Loop over vertices until nothing is scheduled
@@ -80,7 +84,7 @@ void Compute(graph<vertex> &GA, commandLine P)
         activeVertices = currentSchedule.numTasks();
 
         // Parallel loop where each vertex is assigned a color
-        parallel_for(uintT v_i = 0; v_i < numVertices; v_i++)
+        parallel_for(0, numVertices, [&] (uintT v_i)
         {
             if (currentSchedule.isScheduled(v_i))
             {
@@ -88,33 +92,24 @@ void Compute(graph<vertex> &GA, commandLine P)
                 const uintT vDegree = GA.V[v_i].getOutDegree();
                 const uintT vMaxColor = vDegree + 1;
                 bool scheduleNeighbors = false;
-                uintT newColor = 0;
                 uintT currentColor = colorData[v_i].color; 
                 
                 activeEdges += vDegree;
 
-                // Make bool array for possible color values and then set any color
-                // already taken by neighbours to false
-                std::vector<bool> possibleColors(maxDegree + 1, true);
+                // Set of colors already taken by neighbours
+                ForbiddenColors &forbiddenColors = workerColors.local();
 
                 // Get colors (need write lock on self and reader locks on all neighbours)
-                while (!GetPossibleColors(GA, colorData, possibleColors, v_i)) {}
+                while (!GetPossibleColors(GA, colorData, forbiddenColors, v_i)) {}
                 
-                // Find minimum color by iterating through color array in increasing order
-                while (newColor <= vMaxColor)
-                {                    
-                    // If color is available and it is not the vertex's current value then try to assign
-                    if (possibleColors[newColor])
-                    {
-                        if (currentColor != newColor)
-                        {
-                            colorData[v_i].color = newColor;
-                            scheduleNeighbors = true;
-                            changedVertices++;
-                        }
-                        break;
-                    }
-                    newColor++;
+                // Assign the minimum color not taken by a neighbour if it is
+                // not the vertex's current value
+                uintT newColor = forbiddenColors.firstFree();
+                if (newColor <= vMaxColor && currentColor != newColor)
+                {
+                    colorData[v_i].color = newColor;
+                    scheduleNeighbors = true;
+                    changedVertices++;
                 }
 
                 // Release locks
@@ -130,7 +125,7 @@ void Compute(graph<vertex> &GA, commandLine P)
                     }
                 }
             }
-        }
+        });
         if (verbose)
         {
             std::cout << "\tActive Vs: " << activeVertices << std::endl;
@@ -140,6 +135,7 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    benchCounters.iterations = iter - 1;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
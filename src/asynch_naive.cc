@@ -23,123 +23,49 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "coloring_base.h"
+#include "asynch_naive.h"
+#include "easy_graphs.h"
+#include "anytime.h"
 
 // Naive coloring implementation
 template <class vertex>
 void Compute(graph<vertex> &GA, commandLine P)
 {
-    timer fullTimer, iterTimer;
+    timer fullTimer;
     fullTimer.start();
     
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
-    std::vector<uintT> colorData(numVertices, maxDegree);
+    colorVector colorData = makeColorVector(numVertices, maxDegree);
     // randomizeColors(GA, colorData);
     // std::vector<uintT> minimalColor(numVertices, 0);
 
     // Verbose variables
     bool verbose = true;
-    uintT activeVertices;
-    uintT activeEdges;
-    uintT changedVertices;
 
-    // Make new scheduler and schedule all vertices
-    BitsetScheduler currentSchedule(numVertices);
-    currentSchedule.reset();
-    currentSchedule.scheduleAll(false);
-
-    double lastStopTime = iterTimer.getTime();
-
-    // Loop over vertices until nothing is scheduled
+    // Bipartite graphs, forests, paths and cycles skip the engine
+    // (-fast-paths)
+    const bool fastPath = P.getOption("-fast-paths") && colorEasyGraph(GA, colorData, maxDegree, verbose);
     uint64_t iter = 0;
-    while (currentSchedule.anyScheduledTasks())
+    bool firstFit = true;
+    if (!fastPath)
     {
-        if (verbose)
-        {
-            iter++;
-            std::cout << std::endl;
-            std::cout << "Iteration: " << iter << std::endl;
-        }
-        activeVertices = 0;
-        activeEdges = 0;
-        changedVertices = 0;
-
-        currentSchedule.newIteration();
-        activeVertices = currentSchedule.numTasks();
-
-        // Parallel loop where each vertex is assigned a color
-        parallel_for (uintT v_i = 0; v_i < numVertices; v_i++)
-        {
-            if (currentSchedule.isScheduled(v_i))
-            {
-                // Get current vertex's neighbours
-                const uintT vDegree = GA.V[v_i].getOutDegree();
-                bool scheduleNeighbors = false;
-                // bool removeFromNeigh = false;
-                
-                activeEdges += vDegree;
-
-                // Make bool array for possible color values and then set any color
-                // already taken by neighbours to false
-                std::vector<bool> possibleColors(maxDegree + 1, true);
-                
-                for(uintT n_i = 0; n_i < vDegree; n_i++)
-                {
-                    uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-                    uintT neighVal = colorData[neigh];  
-                    possibleColors[neighVal] = false;      
-                }
-
-                // Find minimum color by iterating through color array in increasing order
-                uintT newColor = 0;
-                uintT oldColor = colorData[v_i]; 
-                while (newColor <= vDegree)
-                {                    
-                    // If color is available and it is not the vertex's current value then try to assign
-                    if (possibleColors[newColor])
-                    {
-                        if (oldColor != newColor)
-                        {
-                            colorData[v_i] = newColor;
-                            // if (newColor == minimalColor[v_i])
-                            //     removeFromNeigh = true;
-                            scheduleNeighbors = true;
-                            changedVertices++;
-                        }
-                        break;
-                    }
-                    newColor++;
-                }
-
-                // Schedule all neighbours if required
-                if (scheduleNeighbors)
-                {
-                    for (uintT n_i = 0; n_i < vDegree; n_i++)
-                    {
-                        uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-                        if (oldColor < colorData[neigh] || colorData[v_i] == colorData[neigh])
-                            currentSchedule.schedule(neigh, false);
-                    }
-                }
-            }
-        }
-        if (verbose)
-        {
-            std::cout << "\tActive Vs: " << activeVertices << std::endl;
-            std::cout << "\tActive Es: " << activeEdges << std::endl;
-            std::cout << "\tModified Vs: " << changedVertices << std::endl;
-            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
-            lastStopTime = iterTimer.getTime();
-        }
+        // With -deadline-ms the best valid coloring found in time is returned
+        const long deadlineMs = P.getOptionLongValue("-deadline-ms", 0);
+        if (deadlineMs > 0)
+            iter = colorAnytime(GA, colorData, maxDegree, P, deadlineMs, verbose, firstFit);
+        else
+            iter = colorAsynchNaive(GA, colorData, maxDegree, P, verbose);
     }
+    benchCounters.iterations = iter;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph and cleanup
-    assessGraph(GA, colorData, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P, firstFit);
 }
\ No newline at end of file
@@ -32,13 +32,13 @@ void Compute(graph<vertex> &GA, commandLine P)
     fullTimer.start();
     
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
-    std::vector<uintT> colorData(numVertices, maxDegree);
+    colorVector colorData = makeColorVector(numVertices, maxDegree);
     // randomizeColors(GA, colorData);
-    std::vector<uintT> potentialColor(numVertices, maxDegree);
+    colorVector potentialColor = makeColorVector(numVertices, maxDegree);
 
     // Verbose variables
     bool verbose = true;
@@ -51,15 +51,32 @@ void Compute(graph<vertex> &GA, commandLine P)
     currentSchedule.reset();
     currentSchedule.scheduleAll(false);
 
+    // Vertices with at least this many neighbours are colored with nested
+    // parallelism (-hub-degree)
+    const uintT hubDegree = P.getOptionLongValue("-hub-degree", HUB_DEGREE_DEFAULT);
+
+    // Per-worker forbidden color sets for the first-fit search
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Optional software prefetching K vertices ahead of the loop (-prefetch K)
+    PrefetchPipeline<vertex, colorVector> pipeline(GA, colorData, P.getOptionLongValue("-prefetch", 0));
+    auto scheduledAt = [&] (size_t pos) -> uintT
+    {
+        return currentSchedule.isScheduled(pos) ? pos : UINT_T_MAX;
+    };
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
+
     double lastStopTime = iterTimer.getTime();
 
     // Loop over vertices until nothing is scheduled
     uint64_t iter = 0;
     while (currentSchedule.anyScheduledTasks())
     {
+        iter++;
         if (verbose)
         {
-            iter++;
             std::cout << std::endl;
             std::cout << "Iteration: " << iter << std::endl;
         }
@@ -71,8 +88,10 @@ void Compute(graph<vertex> &GA, commandLine P)
         activeVertices = currentSchedule.numTasks();
 
         // Parallel loop where each vertex is assigned a color
-        parallel_for (uintT currentNode = 0; currentNode < numVertices; currentNode++)
+        vertexLoop.run([&] (uintT currentNode)
         {
+            pipeline.ahead(currentNode, numVertices, scheduledAt);
+
             if (currentSchedule.isScheduled(currentNode))
             {
                 // Get current vertex's neighbours
@@ -80,33 +99,16 @@ void Compute(graph<vertex> &GA, commandLine P)
                 
                 activeEdges += vDegree;
 
-                // Make bool array for possible color values and then set any color
-                // already taken by neighbours to false
-                std::vector<bool> possibleColors(maxDegree + 1, true);
-                
-                for(uintT n_i = 0; n_i < vDegree; n_i++)
-                {
-                    uintT neighbourNode = GA.V[currentNode].getOutNeighbor(n_i);
-                    uintT neighVal = colorData[neighbourNode];  
-                    possibleColors[neighVal] = false;
-                }
-
-                // Find minimum color by iterating through color array in increasing order
-                uintT newColor = 0;
+                // Mark the colors already taken by neighbours
+                // and propose the minimum color not taken by a neighbour if it
+                // is not the vertex's current value
+                uintT newColor = firstFitColor(GA.V[currentNode], colorData, workerColors.local(),
+                                               vDegree, hubDegree);
                 uintT oldColor = colorData[currentNode]; 
-                while (newColor <= vDegree)
-                {                    
-                    // If color is available and it is not the vertex's current value then try to assign
-                    if (possibleColors[newColor])
-                    {
-                        if (oldColor != newColor)
-                        {
-                            potentialColor[currentNode] = newColor;
-                            changedVertices++;
-                        }
-                        break;
-                    }
-                    newColor++;
+                if (newColor <= vDegree && oldColor != newColor)
+                {
+                    potentialColor[currentNode] = newColor;
+                    changedVertices++;
                 }
 
                 // Verify that color change is non-conflicting
@@ -133,7 +135,7 @@ void Compute(graph<vertex> &GA, commandLine P)
                     }
                 }
             }
-        }
+        });
         if (verbose)
         {
             std::cout << "\tActive Vs: " << activeVertices << std::endl;
@@ -143,11 +145,13 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    vertexLoop.del();
+    benchCounters.iterations = iter;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph and cleanup
-    assessGraph(GA, colorData, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
 }
\ No newline at end of file
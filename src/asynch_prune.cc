@@ -0,0 +1,232 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "coloring_base.h"
+
+// Parallel coloring with neighbour pruning. A vertex is settled once it
+// holds minimalColor, the lowest color it can ever have: every color below
+// it belongs to a settled neighbour. Settled vertices never change again,
+// so they are dropped from the neighbour lists of the vertices whose
+// minimalColor already covers their color.
+//
+// Every vertex keeps a copy of its edges whose first activeDegree entries
+// are the ones still scanned. Settling a vertex marks its reverse edges
+// dead (found in O(1) through the reverse edge index), and the owner of a
+// list swap-removes dead edges the next time it scans it, so lists are
+// only ever modified by one worker.
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer, iterTimer;
+    fullTimer.start();
+
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+    
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    colorVector minimalColor = makeColorVector(numVertices, 0);
+    colorVector colorData(numVertices); 
+    numaPlaceVertexArray(colorData.data(), numVertices, sizeof(uintT));
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        colorData[v_i] = GA.V[v_i].getOutDegree();
+    });
+
+    // Copy of the edges in CSR form and the reverse edge index
+    uintT* offsets = edgeOffsets(GA);
+    const uintT numEdges = offsets[numVertices];
+    uintE* targets = newA(uintE, numEdges);
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        for (uintT n_i = 0; n_i < vDegree; n_i++)
+            targets[offsets[v_i] + n_i] = GA.V[v_i].getOutNeighbor(n_i);
+    });
+    uintT* rev = reverseEdges(GA, offsets, P);
+
+    // Active prefix of every vertex's edge list, holding edge positions
+    uintT* activeEdgeList = newA(uintT, numEdges);
+    uintT* activeDegree = newA(uintT, numVertices);
+    bool* dead = newA(bool, numEdges);
+    bool* settled = newA(bool, numVertices);
+    bool* settleCandidate = newA(bool, numVertices);
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        for (uintT e_i = offsets[v_i]; e_i < offsets[v_i + 1]; e_i++)
+        {
+            activeEdgeList[e_i] = e_i;
+            dead[e_i] = false;
+        }
+        activeDegree[v_i] = offsets[v_i + 1] - offsets[v_i];
+        settled[v_i] = false;
+        settleCandidate[v_i] = false;
+    });
+
+    // Verbose variables
+    bool verbose = true;
+    uintT activeVertices;
+    uintT activeEdges;
+    uintT changedVertices;
+    uintT settledVertices;
+    uintT prunedEdges = 0;
+
+    // Make new scheduler and schedule all vertices
+    BitsetScheduler currentSchedule(numVertices);
+    currentSchedule.reset();
+    currentSchedule.scheduleAll(false);
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
+
+    double lastStopTime = iterTimer.getTime();
+    
+    // Loop over vertices until nothing is scheduled
+    uint64_t iter = 0;
+    while (currentSchedule.anyScheduledTasks())
+    {
+        iter++;
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << iter << std::endl;
+        }
+        activeEdges = 0;
+        changedVertices = 0;
+        settledVertices = 0;
+
+        currentSchedule.newIteration();
+        activeVertices = currentSchedule.numTasks();
+
+        // Parallel loop where each vertex is assigned a color
+        vertexLoop.run([&] (uintT v_i)
+        {
+            if (currentSchedule.isScheduled(v_i) && !settled[v_i])
+            {
+                const uintT vDegree = GA.V[v_i].getOutDegree();
+                uintT* vEdges = activeEdgeList + offsets[v_i];
+                ForbiddenColors &forbiddenColors = workerColors.local();
+                forbiddenColors.reset(vDegree);
+
+                // Colors below minimalColor belong to settled neighbours
+                for (uintT c_i = 0; c_i < minimalColor[v_i]; c_i++)
+                    forbiddenColors.mark(c_i);
+
+                // Mark the colors of the active neighbours, swap-removing the dead edges
+                uintT n_i = 0;
+                while (n_i < activeDegree[v_i])
+                {
+                    if (dead[vEdges[n_i]])
+                    {
+                        vEdges[n_i] = vEdges[--activeDegree[v_i]];
+                        continue;
+                    }
+                    forbiddenColors.mark(colorData[targets[vEdges[n_i]]]);
+                    n_i++;
+                }
+                writeAdd(&activeEdges, activeDegree[v_i]);
+
+                uintT newColor = forbiddenColors.firstFree();
+                uintT oldColor = colorData[v_i];
+                if (newColor == minimalColor[v_i])
+                    settleCandidate[v_i] = true;
+
+                // Assign the color and schedule the neighbours it affects
+                if (newColor <= vDegree && oldColor != newColor)
+                {
+                    colorData[v_i] = newColor;
+                    writeAdd(&changedVertices, (uintT) 1);
+                    for (n_i = 0; n_i < activeDegree[v_i]; n_i++)
+                    {
+                        uintE neigh = targets[vEdges[n_i]];
+                        if (oldColor < colorData[neigh] || newColor == colorData[neigh])
+                            currentSchedule.schedule(neigh, false);
+                    }
+                }
+            }
+        });
+
+        // Settle the candidates that do not share their color with a neighbour.
+        // Colors do not change in this phase, so the check is stable.
+        vertexLoop.run([&] (uintT v_i)
+        {
+            if (settleCandidate[v_i])
+            {
+                settleCandidate[v_i] = false;
+                const uintT vColor = colorData[v_i];
+                const uintT* vEdges = activeEdgeList + offsets[v_i];
+                bool conflict = false;
+                for (uintT n_i = 0; n_i < activeDegree[v_i] && !conflict; n_i++)
+                    conflict = (colorData[targets[vEdges[n_i]]] == vColor);
+                if (conflict)
+                    return;
+
+                settled[v_i] = true;
+                writeAdd(&settledVertices, (uintT) 1);
+                for (uintT n_i = 0; n_i < activeDegree[v_i]; n_i++)
+                {
+                    // The neighbour may only forget this vertex once its
+                    // minimalColor is above vColor
+                    uintT neigh = targets[vEdges[n_i]];
+                    CAS(&minimalColor[neigh], vColor, vColor + 1);
+                    const uintT reverse = rev[vEdges[n_i]];
+                    if (minimalColor[neigh] > vColor && reverse != UINT_T_MAX)
+                    {
+                        dead[reverse] = true;
+                        writeAdd(&prunedEdges, (uintT) 1);
+                    }
+                }
+            }
+        });
+
+        if (verbose)
+        {
+            std::cout << "\tActive Vs: " << activeVertices << std::endl;
+            std::cout << "\tActive Es: " << activeEdges << std::endl;
+            std::cout << "\tModified Vs: " << changedVertices << std::endl;
+            std::cout << "\tSettled Vs: " << settledVertices << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+    }
+    vertexLoop.del();
+    benchCounters.iterations = iter;
+    if (verbose)
+    {
+        cout << "\nPruned Es : " << prunedEdges;
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    free(offsets);
+    free(targets);
+    free(rev);
+    free(activeEdgeList);
+    free(activeDegree);
+    free(dead);
+    free(settled);
+    free(settleCandidate);
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
+}
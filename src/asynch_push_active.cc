@@ -33,32 +33,34 @@ void Compute(graph<vertex> &GA, commandLine P)
     fullTimer.start();
     
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
 
-    const uintT initialColor = 500;
-    std::vector<uintT> currentColor(numVertices, initialColor);
-    std::vector<uintT> potentialColor(numVertices, 0);
-    std::vector<std::vector<uintT>> neighborColors(numVertices, std::vector<uintT>(initialColor));
-
-    // Initialize neighbourColors so that each vertex has [initialColor] = # of neighbours
-    for (uintT v_i = 0; v_i < numVertices; v_i++)
-    {
-        neighborColors[v_i][initialColor] =  GA.V[v_i].getOutDegree();
-    }
+    // Vertices start uncolored, which the neighbour color counters ignore
+    colorVector currentColor = makeColorVector(numVertices, UINT_T_MAX);
+    colorVector potentialColor = makeColorVector(numVertices, 0);
+    NeighborColorCounts neighborColors(GA, P.getOptionLongValue("-color-cap", 0));
 
     // Verbose variables
     bool verbose = true;
     uintT activeVertices;
     uintT activeEdges;
     uintT changedVertices;
+    if (verbose)
+    {
+        std::cout << "Neighbour color counters: " << (neighborColors.bytes() >> 20) << " MB" << std::endl;
+    }
 
     // Make new scheduler and schedule all vertices
     BitsetScheduler currentSchedule(numVertices);
     currentSchedule.reset();
     currentSchedule.scheduleAll();
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
 
     double lastStopTime = iterTimer.getTime();
 
@@ -86,7 +88,7 @@ void Compute(graph<vertex> &GA, commandLine P)
         activeVertices = currentSchedule.numTasks();
 
         // Parallel loop where each vertex is assigned a color
-        parallel_for (uintT v_i = 0; v_i < numVertices; v_i++)
+        vertexLoop.run([&] (uintT v_i)
         {
             if (currentSchedule.isScheduled(v_i))
             {
@@ -107,42 +109,28 @@ void Compute(graph<vertex> &GA, commandLine P)
                     for (uintT n_i = 0; n_i < vDegree; n_i++)
                     {
                         uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-                        uintT oldCount;
-                        uintT newCount;
 
-                        do
-                        {
-                            oldCount = neighborColors[neigh][oldColor];
-                            newCount = oldCount - 1;
-                        } while (!CAS(&neighborColors[neigh][oldColor], oldCount, newCount));
-                        
-                        do
-                        {
-                            oldCount = neighborColors[neigh][newColor];
-                            newCount = oldCount + 1;
-                        } while (!CAS(&neighborColors[neigh][newColor], oldCount, newCount));
+                        neighborColors.remove(neigh, oldColor);
+                        neighborColors.add(neigh, newColor);
 
                         currentSchedule.schedule(neigh, false);
 
                         // If change to current node opened up better color for neighbour, neighbour takes it
-                        if (neighborColors[neigh][oldColor] == 0 && oldColor < potentialColor[neigh])
+                        if (oldColor < neighborColors.tracked(neigh) && neighborColors.count(neigh, oldColor) == 0
+                            && oldColor < potentialColor[neigh])
                         {
                             potentialColor[neigh] = oldColor;
                         }
                         // If change to current node made potential color worse for neighbour, neighbour finds new potential.
                         else if (newColor == potentialColor[neigh])
                         {   
-                            uintT neighPotentialColor = newColor;
-                            while (neighborColors[neigh][neighPotentialColor] != 0)
-                            {
-                                neighPotentialColor++;
-                            }
-                            potentialColor[neigh] = neighPotentialColor;
+                            potentialColor[neigh] = firstFreeColor(neighborColors, GA.V[neigh], neigh,
+                                                                   currentColor, workerColors.local(), newColor);
                         }
                     }
                 }
             }
-        }
+        });
 
         if (verbose)
         {
@@ -153,11 +141,13 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    vertexLoop.del();
+    benchCounters.iterations = iter - 1;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph
-    assessGraph(GA, currentColor, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, currentColor, maxDegree, P);
 }
\ No newline at end of file
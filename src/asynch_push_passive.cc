@@ -35,27 +35,29 @@ void Compute(graph<vertex> &GA, commandLine P)
     bool verbose = true;
     
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
 
-    const uintT maxColor = 500;
-    std::vector<uintT> colorData(numVertices, maxColor);
+    // Vertices start uncolored, which the neighbour color counters ignore
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
     // randomizeColors(GA, colorData);
-    std::vector<std::vector<uintT>> neighborColors(numVertices, std::vector<uintT>(maxColor));
+    NeighborColorCounts neighborColors(GA, P.getOptionLongValue("-color-cap", 0));
     std::vector<std::mutex> colorLock(numVertices);
-    
-    // Initialize neighbourColors so that each vertex has [maxColor] = # of neighbours
-    for (uintT v_i = 0; v_i < numVertices; v_i++)
+    if (verbose)
     {
-        neighborColors[v_i][maxColor] =  GA.V[v_i].getOutDegree();
+        std::cout << "Neighbour color counters: " << (neighborColors.bytes() >> 20) << " MB" << std::endl;
     }
 
     // Make new scheduler and schedule all vertices
     BitsetScheduler currentSchedule(numVertices);
     currentSchedule.reset();
     currentSchedule.scheduleAll();
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
 
     double lastStopTime = iterTimer.getTime();
 
@@ -83,36 +85,27 @@ void Compute(graph<vertex> &GA, commandLine P)
         activeVertices = currentSchedule.numTasks();
 
         // Parallel loop where each vertex is assigned a color
-        parallel_for (uintT v_i = 0; v_i < numVertices; v_i++)
+        vertexLoop.run([&] (uintT v_i)
         {
             if (currentSchedule.isScheduled(v_i))
             {
                 // Get current vertex's neighbours
                 const uintT vDegree = GA.V[v_i].getOutDegree();
-                const uintT vMaxColor = vDegree + 1;
                 bool scheduleNeighbors = false;
                 
                 activeEdges += vDegree;
 
-                // Find minimum color by iterating through color array in increasing order
-                uintT newColor = 0;
+                // Find minimum color no neighbour has
                 uintT oldColor = colorData[v_i];
                 
                 colorLock[v_i].lock();
-                while (newColor <= vMaxColor)
-                {                    
-                    // If color is available and it is not the vertex's current value then try to assign
-                    if (neighborColors[v_i][newColor] == 0)
-                    {
-                        if (oldColor != newColor)
-                        {
-                            colorData[v_i] = newColor;
-                            scheduleNeighbors = true;
-                            changedVertices++;
-                        }
-                        break;
-                    }
-                    newColor++;
+                uintT newColor = firstFreeColor(neighborColors, GA.V[v_i], v_i, colorData, workerColors.local());
+                // If it is not the vertex's current value then assign it
+                if (oldColor != newColor)
+                {
+                    colorData[v_i] = newColor;
+                    scheduleNeighbors = true;
+                    changedVertices++;
                 }
                 colorLock[v_i].unlock();
 
@@ -124,11 +117,11 @@ void Compute(graph<vertex> &GA, commandLine P)
                         uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
 
                         colorLock[neigh].lock();
-                        neighborColors[neigh][newColor]++;
-                        neighborColors[neigh][oldColor]--;
+                        neighborColors.add(neigh, newColor);
+                        neighborColors.remove(neigh, oldColor);
                         colorLock[neigh].unlock();
 
-                        if ((neighborColors[neigh][oldColor] == 0 && oldColor < colorData[neigh])
+                        if ((neighborColors.count(neigh, oldColor) == 0 && oldColor < colorData[neigh])
                              || colorData[v_i] == colorData[neigh])
                         {
                             currentSchedule.schedule(neigh, false);
@@ -136,7 +129,7 @@ void Compute(graph<vertex> &GA, commandLine P)
                     }
                 }
             }
-        }
+        });
 
         if (verbose)
         {
@@ -147,11 +140,13 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    vertexLoop.del();
+    benchCounters.iterations = iter - 1;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph and cleanup
-    assessGraph(GA, colorData, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
 }
\ No newline at end of file
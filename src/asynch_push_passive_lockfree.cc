@@ -0,0 +1,161 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "coloring_base.h"
+
+
+// Passive push coloring without locks: neighbour color counts are updated
+// atomically and every vertex keeps a smallest-free-color hint
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer, iterTimer;
+    fullTimer.start();
+    // Verbose variables
+    bool verbose = true;
+    
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+    
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+
+    // Vertices start uncolored, which the neighbour color counters ignore
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
+    // randomizeColors(GA, colorData);
+    NeighborColorCounts neighborColors(GA, P.getOptionLongValue("-color-cap", 0));
+    // Lower bound on the smallest free color of each vertex. Colors below it
+    // were taken at the last scan, and a neighbour that frees one lowers it
+    // with writeMin.
+    colorVector freeHint = makeColorVector(numVertices, 0);
+    if (verbose)
+    {
+        std::cout << "Neighbour color counters: " << (neighborColors.bytes() >> 20) << " MB" << std::endl;
+    }
+
+    // Make new scheduler and schedule all vertices
+    BitsetScheduler currentSchedule(numVertices);
+    currentSchedule.reset();
+    currentSchedule.scheduleAll();
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
+
+    double lastStopTime = iterTimer.getTime();
+
+    // Loop over vertices until nothing is scheduled
+    uint64_t iter = 0;
+    while (true)
+    {
+        iter++;
+        // Check if schedule is empty and break out of loop if it is
+        if (currentSchedule.anyScheduledTasks() == false)
+        {
+            break;
+        }
+
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << iter << std::endl;
+        }
+        uintT activeVertices = 0;
+        uintT activeEdges = 0;
+        uintT changedVertices = 0;
+
+        currentSchedule.newIteration();
+        activeVertices = currentSchedule.numTasks();
+
+        // Parallel loop where each vertex is assigned a color
+        vertexLoop.run([&] (uintT v_i)
+        {
+            if (currentSchedule.isScheduled(v_i))
+            {
+                // Get current vertex's neighbours
+                const uintT vDegree = GA.V[v_i].getOutDegree();
+                bool scheduleNeighbors = false;
+                
+                writeAdd(&activeEdges, vDegree);
+
+                // Find minimum color no neighbour has, starting from the hint
+                uintT oldColor = colorData[v_i];
+                uintT hint = freeHint[v_i];
+                uintT newColor = firstFreeColor(neighborColors, GA.V[v_i], v_i, colorData, workerColors.local(), hint);
+                // A neighbour freeing a lower color in the meantime has lowered the
+                // hint, in which case it is kept
+                CAS(&freeHint[v_i], hint, newColor);
+
+                // If it is not the vertex's current value then assign it
+                if (oldColor != newColor)
+                {
+                    colorData[v_i] = newColor;
+                    scheduleNeighbors = true;
+                    writeAdd(&changedVertices, (uintT) 1);
+                }
+
+                // Schedule all neighbours if required
+                if (scheduleNeighbors)
+                {
+                    for (uintT n_i = 0; n_i < vDegree; n_i++)
+                    {
+                        uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+
+                        neighborColors.add(neigh, newColor);
+                        bool freed = neighborColors.remove(neigh, oldColor);
+                        if (freed)
+                        {
+                            writeMin(&freeHint[neigh], oldColor);
+                        }
+
+                        // Untracked colors of capped vertices may have been freed too
+                        if (((freed || oldColor >= neighborColors.tracked(neigh)) && oldColor < colorData[neigh])
+                             || colorData[v_i] == colorData[neigh])
+                        {
+                            currentSchedule.schedule(neigh, false);
+                        }
+                    }
+                }
+            }
+        });
+
+        if (verbose)
+        {
+            std::cout << "\tActive Vs: " << activeVertices << std::endl;
+            std::cout << "\tActive Es: " << activeEdges << std::endl;
+            std::cout << "\tModified Vs: " << changedVertices << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+    }
+    vertexLoop.del();
+    benchCounters.iterations = iter - 1;
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
+}
\ No newline at end of file
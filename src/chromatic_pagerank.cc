@@ -0,0 +1,111 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include <cmath>
+
+#include "coloring_base.h"
+#include "jones_plassmann.h"
+#include "chromatic_executor.h"
+
+// Sample consumer of the chromatic executor: PageRank with Gauss-Seidel
+// sweeps. The graph is colored with Jones-Plassmann, then every sweep
+// updates the ranks class by class in place, each vertex reading the
+// current ranks of its neighbours. Runs until the L1 change of a sweep
+// drops below -eps (default 1e-7) or for -maxiters sweeps (default 100).
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer, iterTimer;
+    fullTimer.start();
+
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    const double damping = 0.85;
+    const double epsilon = P.getOptionDoubleValue("-eps", 1e-7);
+    const long maxIters = P.getOptionLongValue("-maxiters", 100);
+
+    // Verbose variables
+    bool verbose = true;
+
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
+    iterTimer.start();
+    colorJonesPlassmann(GA, colorData, maxDegree, false);
+    ChromaticExecutor<vertex> executor(GA, colorData);
+    if (verbose)
+    {
+        std::cout << "Colors: " << executor.numColors() << std::endl;
+        std::cout << "Coloring Time : " << setprecision(TIME_PRECISION) << iterTimer.next() << std::endl;
+    }
+
+    double* rank = newA(double, numVertices);
+    double* change = newA(double, numVertices);
+    parallel_for (0, numVertices, [&] (size_t v_i)
+    {
+        rank[v_i] = 1.0 / numVertices;
+    });
+
+    double lastStopTime = iterTimer.getTime();
+    long iter = 0;
+    double error = 1.0;
+    while (iter < maxIters && error > epsilon)
+    {
+        iter++;
+        executor.run([&] (uintE v_i)
+        {
+            double sum = 0;
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            for (uintT n_i = 0; n_i < vDegree; n_i++)
+            {
+                uintE neigh = GA.V[v_i].getOutNeighbor(n_i);
+                sum += rank[neigh] / GA.V[neigh].getOutDegree();
+            }
+            double newRank = (1 - damping) / numVertices + damping * sum;
+            change[v_i] = fabs(newRank - rank[v_i]);
+            rank[v_i] = newRank;
+        });
+        error = sequence::reduce<double>((long) 0, (long) numVertices, addF<double>(),
+            [&] (long v_i) { return change[v_i]; });
+
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << iter << std::endl;
+            std::cout << "\tError: " << error << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+    }
+    benchCounters.iterations = iter;
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+        cout << "Rank sum : " << sequence::reduce<double>((long) 0, (long) numVertices, addF<double>(),
+            [&] (long v_i) { return rank[v_i]; }) << "\n";
+    }
+
+    free(rank);
+    free(change);
+}
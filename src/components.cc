@@ -0,0 +1,102 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "coloring_base.h"
+#include "components.h"
+#include "asynch_naive.h"
+#include "jones_plassmann.h"
+
+// Component decomposition. The connected components are found by label
+// propagation, every component but the largest is colored sequentially
+// in batches of components, and the engine (-engine naive, the default,
+// or -engine jp) only runs on the giant component, extracted as a graph
+// of its own so that its iterations do not scan the other vertices. The
+// giant component's colors are then copied back into colorData.
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer, iterTimer;
+    fullTimer.start();
+
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
+
+    // Verbose variables
+    bool verbose = true;
+
+    const string engine = P.getOptionValue("-engine", string("naive"));
+    if (engine != "naive" && engine != "jp")
+    {
+        cout << "Unknown engine " << engine << ", expected naive or jp. Exiting..." << endl;
+        exit(2);
+    }
+
+    double lastStopTime = iterTimer.getTime();
+    ComponentDecomposition<vertex> components(GA);
+    const uintT giant = components.giant();
+    const size_t giantSize = (components.numComponents() > 0) ? components.size(giant) : 0;
+    if (verbose)
+    {
+        std::cout << "Components: " << components.numComponents() << std::endl;
+        std::cout << "\tGiant Vs: " << giantSize << std::endl;
+        std::cout << "\tPropagation rounds: " << components.propagationRounds() << std::endl;
+        std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+        lastStopTime = iterTimer.getTime();
+    }
+
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+    size_t smallVertices = components.colorSmallComponents(colorData, workerColors);
+    if (verbose)
+    {
+        std::cout << "Small components" << std::endl;
+        std::cout << "\tColored Vs: " << smallVertices << std::endl;
+        std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+        lastStopTime = iterTimer.getTime();
+    }
+
+    // Run the engine on the giant component
+    graph<vertex> giantGraph = components.giantSubgraph();
+    const uintT giantMaxDegree = getMaxDeg(giantGraph);
+    colorVector giantColors = makeColorVector(giantSize, giantMaxDegree);
+    uint64_t iter;
+    if (engine == "jp")
+        iter = colorJonesPlassmann(giantGraph, giantColors, giantMaxDegree, verbose);
+    else
+        iter = colorAsynchNaive(giantGraph, giantColors, giantMaxDegree, P, verbose);
+    components.stitchGiant(giantColors, colorData);
+    giantGraph.del();
+
+    benchCounters.iterations = iter;
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
+}
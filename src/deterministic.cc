@@ -0,0 +1,92 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "coloring_base.h"
+#include "jones_plassmann.h"
+
+// Deterministic coloring implementation. With -verify-determinism <list>
+// the coloring is recomputed with each worker count in the comma
+// separated list and compared against the first one. A mismatch exits
+// with status 1.
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer;
+    fullTimer.start();
+    
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+    
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
+
+    // Verbose variables
+    bool verbose = true;
+
+    // Vertices with at least this many neighbours are colored with nested
+    // parallelism (-hub-degree)
+    const uintT hubDegree = P.getOptionLongValue("-hub-degree", HUB_DEGREE_DEFAULT);
+
+    uintT rounds = colorJonesPlassmann(GA, colorData, maxDegree, verbose, hubDegree);
+    benchCounters.iterations = rounds;
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    std::cout << "Coloring hash: " << std::hex << coloringHash(colorData) << std::dec << std::endl;
+
+    // The check runs on the Jones-Plassmann coloring, before any
+    // post-processing changes it
+    if (P.getOption("-verify-determinism"))
+    {
+        const int workers = getWorkers();
+        std::vector<int> workerList = parseWorkerList(P.getOptionValue("-verify-determinism", string("")));
+        colorVector otherColors(numVertices);
+        bool identical = true;
+        for (size_t w_i = 0; w_i < workerList.size(); w_i++)
+        {
+            setWorkers(workerList[w_i]);
+            colorJonesPlassmann(GA, otherColors, maxDegree, false, hubDegree);
+            long differing = sequence::reduce<long>((long) 0, (long) numVertices, addF<long>(),
+                [&] (long v_i) -> long { return colorData[v_i] != otherColors[v_i]; });
+            std::cout << "Determinism check: workers=" << workerList[w_i] << " "
+                      << (differing == 0 ? "identical" : "differs") ;
+            if (differing != 0)
+                std::cout << " on " << differing << " vertices";
+            std::cout << std::endl;
+            identical = identical && (differing == 0);
+        }
+        setWorkers(workers);
+        numaBindWorkers();
+        if (!identical)
+        {
+            std::cout << "Failure: coloring depends on the worker count" << std::endl;
+            exit(1);
+        }
+    }
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
+}
@@ -0,0 +1,284 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "coloring_base.h"
+
+// Peels the vertices whose remaining degree drops below k. A vertex is
+// returned by the round in which its degree crosses k - 1, so only once.
+struct KCore_Peel
+{
+    intT* degrees;
+    bool* peeled;
+    intT k;
+    KCore_Peel(intT* _degrees, bool* _peeled, intT _k) : degrees(_degrees), peeled(_peeled), k(_k) { }
+
+    inline bool update(uintE s, uintE d)
+    {
+        return degrees[d]-- == k;
+    }
+
+    inline bool updateAtomic(uintE s, uintE d)
+    {
+        return __sync_fetch_and_sub(&degrees[d], 1) == k;
+    }
+
+    inline bool cond(uintE d)
+    {
+        return !peeled[d];
+    }
+};
+
+// Marks the vertices of the k-core of GA in inCore, by repeatedly peeling
+// every vertex of degree below k. Returns the number of rounds.
+template <class vertex>
+uintT markKCore(graph<vertex> &GA, intT k, bool* inCore)
+{
+    const size_t numVertices = GA.n;
+    intT* degrees = newA(intT, numVertices);
+    bool* peeled = newA(bool, numVertices);
+    bool* first = newA(bool, numVertices);
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        degrees[v_i] = GA.V[v_i].getOutDegree();
+        peeled[v_i] = false;
+        first[v_i] = (degrees[v_i] < k);
+    });
+    vertexSubset frontier(numVertices, first);
+
+    uintT rounds = 0;
+    while (!frontier.isEmpty())
+    {
+        rounds++;
+        vertexMap(frontier, [&] (uintE v_i)
+        {
+            peeled[v_i] = true;
+        });
+        vertexSubset next = edgeMap(GA, frontier, KCore_Peel(degrees, peeled, k));
+        frontier.del();
+        frontier = next;
+    }
+    frontier.del();
+
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        inCore[v_i] = !peeled[v_i];
+    });
+    free(degrees);
+    free(peeled);
+    return rounds;
+}
+
+// Hub-first coloring. Conflicts and recolorings concentrate among the
+// dense high-degree core, while the long tail of low-degree vertices
+// hardly ever conflicts. The core (the -core-size K vertices of highest
+// degree, n/100 by default, or with -kcore K the K-core of the graph) is
+// colored first by sequential largest-degree-first greedy. The periphery
+// is then colored in one parallel sweep against the fixed core colors,
+// and the few conflicts between periphery vertices are fixed in rounds
+// where the vertex of higher id in a conflict recolors.
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer, iterTimer;
+    fullTimer.start();
+
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    colorVector colorData = makeColorVector(numVertices, UINT_T_MAX);
+
+    // Verbose variables
+    bool verbose = true;
+    uintT activeVertices;
+    uintT activeEdges;
+    uintT changedVertices;
+
+    // Vertices with at least this many neighbours are colored with nested
+    // parallelism (-hub-degree)
+    const uintT hubDegree = P.getOptionLongValue("-hub-degree", HUB_DEGREE_DEFAULT);
+
+    // Per-worker forbidden color sets for the first-fit search
+    WorkerForbiddenColors workerColors(maxDegree + 1);
+
+    // Vertex blocks of equal edge counts for the iteration loops
+    edgeBalancedBlocks vertexLoop = vertexBlocks(GA);
+
+    double lastStopTime = iterTimer.getTime();
+
+    // Vertices by decreasing degree
+    uintE* order = newA(uintE, numVertices);
+    parallel_for (0, numVertices, [&] (uintT v_i)
+    {
+        order[v_i] = v_i;
+    });
+    intSort::iSort(order, numVertices, maxDegree + 1,
+        [&] (uintE v_i) { return maxDegree - GA.V[v_i].getOutDegree(); });
+
+    // Select the core
+    bool* inCore = newA(bool, numVertices);
+    const long kCore = P.getOptionLongValue("-kcore", 0);
+    if (kCore > 0)
+    {
+        uintT peelRounds = markKCore(GA, kCore, inCore);
+        if (verbose)
+            std::cout << "Peeling rounds: " << peelRounds << std::endl;
+    }
+    else
+    {
+        const size_t coreSize = std::min((size_t) P.getOptionLongValue("-core-size", numVertices / 100),
+                                         numVertices);
+        parallel_for (0, numVertices, [&] (uintT o_i)
+        {
+            inCore[order[o_i]] = (o_i < coreSize);
+        });
+    }
+    uintE* core = newA(uintE, numVertices);
+    const size_t coreSize = pbbs::filterf(order, core, numVertices,
+        [&] (uintE v_i) { return inCore[v_i]; });
+    free(order);
+
+    // Iteration 1: largest-degree-first greedy on the core. Uncolored
+    // periphery neighbours (UINT_T_MAX) are ignored by mark.
+    uint64_t iter = 1;
+    activeEdges = 0;
+    ForbiddenColors &coreColors = workerColors.local();
+    for (size_t c_i = 0; c_i < coreSize; c_i++)
+    {
+        const uintE v_i = core[c_i];
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        activeEdges += vDegree;
+        coreColors.reset(vDegree);
+        markNeighborColors(GA.V[v_i], colorData, coreColors);
+        colorData[v_i] = coreColors.firstFree();
+    }
+    if (verbose)
+    {
+        uintT coreColorCount = 0;
+        if (coreSize > 0)
+            coreColorCount = 1 + sequence::reduce<uintT>((long) 0, (long) coreSize, maxF<uintT>(),
+                [&] (long c_i) { return colorData[core[c_i]]; });
+        std::cout << std::endl;
+        std::cout << "Iteration: " << iter << std::endl;
+        std::cout << "\tCore Vs: " << coreSize << std::endl;
+        std::cout << "\tActive Es: " << activeEdges << std::endl;
+        std::cout << "\tCore Colors: " << coreColorCount << std::endl;
+        std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+        lastStopTime = iterTimer.getTime();
+    }
+
+    // Iteration 2: the periphery in one parallel sweep
+    iter++;
+    activeVertices = numVertices - coreSize;
+    activeEdges = 0;
+    vertexLoop.run([&] (uintT v_i)
+    {
+        if (inCore[v_i])
+            return;
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        writeAdd(&activeEdges, vDegree);
+        colorData[v_i] = firstFitColor(GA.V[v_i], colorData, workerColors.local(), vDegree, hubDegree);
+    });
+
+    // Core colors are fixed and were seen by every periphery vertex, so a
+    // conflict is between two periphery vertices colored at the same time
+    auto loses = [&] (uintT v_i) -> bool
+    {
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        for (uintT n_i = 0; n_i < vDegree; n_i++)
+        {
+            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+            if (neigh < v_i && colorData[neigh] == colorData[v_i])
+                return true;
+        }
+        return false;
+    };
+    bool* conflicted = newA(bool, numVertices);
+    vertexLoop.run([&] (uintT v_i)
+    {
+        conflicted[v_i] = !inCore[v_i] && loses(v_i);
+    });
+    vertexSubset frontier(numVertices, conflicted);
+    if (verbose)
+    {
+        std::cout << std::endl;
+        std::cout << "Iteration: " << iter << std::endl;
+        std::cout << "\tActive Vs: " << activeVertices << std::endl;
+        std::cout << "\tActive Es: " << activeEdges << std::endl;
+        std::cout << "\tConflicts: " << frontier.numNonzeros() << std::endl;
+        std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+        lastStopTime = iterTimer.getTime();
+    }
+
+    // Conflict fix: the losers recolor until no conflict is left. The
+    // loser of lowest id always keeps its new color, so every round makes
+    // progress. New conflicts only arise between two losers.
+    while (!frontier.isEmpty())
+    {
+        iter++;
+        activeVertices = frontier.numNonzeros();
+        changedVertices = 0;
+        edgeBalancedFor(GA, frontier, [&] (uintE v_i)
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            colorData[v_i] = firstFitColor(GA.V[v_i], colorData, workerColors.local(), vDegree, hubDegree);
+            writeAdd(&changedVertices, (uintT) 1);
+        });
+
+        bool* next = newA(bool, numVertices);
+        parallel_for (0, numVertices, [&] (uintT v_i)
+        {
+            next[v_i] = false;
+        });
+        vertexMap(frontier, [&] (uintE v_i)
+        {
+            next[v_i] = loses(v_i);
+        });
+        frontier.del();
+        frontier = vertexSubset(numVertices, next);
+
+        if (verbose)
+        {
+            std::cout << std::endl;
+            std::cout << "Iteration: " << iter << std::endl;
+            std::cout << "\tActive Vs: " << activeVertices << std::endl;
+            std::cout << "\tModified Vs: " << changedVertices << std::endl;
+            std::cout << "\tTime: " << setprecision(TIME_PRECISION) << iterTimer.getTime() - lastStopTime << std::endl;
+            lastStopTime = iterTimer.getTime();
+        }
+    }
+    frontier.del();
+    vertexLoop.del();
+    free(inCore);
+    free(core);
+    benchCounters.iterations = iter;
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
+}
@@ -32,11 +32,11 @@ void Compute(graph<vertex> &GA, commandLine P)
     fullTimer.start();
 
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
-    std::vector<uintT> colorData(numVertices, maxDegree); 
+    colorVector colorData = makeColorVector(numVertices, maxDegree); 
     // randomizeColors(GA, colorData);
 
     // Verbose variables
@@ -50,16 +50,25 @@ void Compute(graph<vertex> &GA, commandLine P)
     currentSchedule.reset();
     currentSchedule.scheduleAll(false);
 
+    // Forbidden color set for the first-fit search
+    ForbiddenColors forbiddenColors(maxDegree + 1);
+
+    // Optional software prefetching K vertices ahead of the loop (-prefetch K)
+    PrefetchPipeline<vertex, colorVector> pipeline(GA, colorData, P.getOptionLongValue("-prefetch", 0));
+    auto scheduledAt = [&] (size_t pos) -> uintT
+    {
+        return currentSchedule.isScheduled(pos) ? pos : UINT_T_MAX;
+    };
+
     double lastStopTime = iterTimer.getTime();
     
     // Loop over vertices until nothing is scheduled
     uint64_t iter = 0;
     while (currentSchedule.anyScheduledTasks())
     {
-
+        iter++;
         if (verbose)
         {
-            iter++;
             std::cout << std::endl;
             std::cout << "Iteration: " << iter << std::endl;
         }
@@ -73,6 +82,8 @@ void Compute(graph<vertex> &GA, commandLine P)
         // Parallel loop where each vertex is assigned a color
         for (uintT v_i = 0; v_i < numVertices; v_i++)
         {
+            pipeline.ahead(v_i, numVertices, scheduledAt);
+
             if (currentSchedule.isScheduled(v_i))
             {
                 // Get current vertex's neighbours
@@ -81,34 +92,20 @@ void Compute(graph<vertex> &GA, commandLine P)
                 
                 activeEdges += vDegree;
 
-                // Make bool array for possible color values and then set any color
-                // already taken by neighbours to false
-                std::vector<bool> possibleColors(maxDegree + 1, true);
+                // Mark the colors already taken by neighbours
+                forbiddenColors.reset(vDegree);
                 
-                for (uintT n_i = 0; n_i < vDegree; n_i++)
-                {
-                    uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
-                    uintT neighVal = colorData[neigh];
-                    possibleColors[neighVal] = false;  
-                }
+                markNeighborColors(GA.V[v_i], colorData, forbiddenColors);
 
-                // Find minimum color by iterating through color array in increasing order
-                uintT newColor = 0;
+                // Assign the minimum color not taken by a neighbour if it is
+                // not the vertex's current value
+                uintT newColor = forbiddenColors.firstFree();
                 uintT currentColor = colorData[v_i]; 
-                while (newColor <= vDegree)
-                {                    
-                    // If color is available and it is not the vertex's current value then try to assign
-                    if (possibleColors[newColor])
-                    {
-                        if (currentColor != newColor)
-                        {
-                            colorData[v_i] = newColor;
-                            scheduleNeighbors = true;
-                            changedVertices++;
-                        }
-                        break;
-                    }
-                    newColor++;
+                if (newColor <= vDegree && currentColor != newColor)
+                {
+                    colorData[v_i] = newColor;
+                    scheduleNeighbors = true;
+                    changedVertices++;
                 }
 
                 // Schedule all neighbours if required
@@ -132,11 +129,12 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    benchCounters.iterations = iter;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph and cleanup
-    assessGraph(GA, colorData, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
 }
\ No newline at end of file
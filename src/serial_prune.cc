@@ -32,13 +32,14 @@ void Compute(graph<vertex> &GA, commandLine P)
     fullTimer.start();
 
     // Check that graph is undirected (out degree == in degree for all vertices)
-    ensureUndirected(GA);
+    ensureUndirected(GA, P);
     
     const size_t numVertices = GA.n;
     const uintT maxDegree = getMaxDeg(GA);
     // randomizeColors(GA, colorData);
-    std::vector<uintT> minimalColor(numVertices, 0);
-    std::vector<uintT> colorData(numVertices); 
+    colorVector minimalColor = makeColorVector(numVertices, 0);
+    colorVector colorData(numVertices); 
+    numaPlaceVertexArray(colorData.data(), numVertices, sizeof(uintT));
     for (uintT v_i = 0; v_i < numVertices; v_i++)
     {
         colorData[v_i] = GA.V[v_i].getOutDegree();
@@ -115,9 +116,9 @@ void Compute(graph<vertex> &GA, commandLine P)
     uint64_t iter = 0;
     while (currentSchedule.anyScheduledTasks())
     {
+        iter++;
         if (verbose)
         {
-            iter++;
             std::cout << std::endl;
             std::cout << "Iteration: " << iter << std::endl;
         }
@@ -201,11 +202,12 @@ void Compute(graph<vertex> &GA, commandLine P)
             lastStopTime = iterTimer.getTime();
         }
     }
+    benchCounters.iterations = iter;
     if (verbose)
     {
         cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
     }
 
-    // Assess graph and cleanup
-    assessGraph(GA, colorData, maxDegree);
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P);
 }
\ No newline at end of file
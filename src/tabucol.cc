@@ -0,0 +1,379 @@
+// This code is part of the project "Ligra: A Lightweight Graph Processing
+// Framework for Shared Memory", presented at Principles and Practice of
+// Parallel Programming, 2013.
+// Copyright (c) 2013 Julian Shun and Guy Blelloch
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights (to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <atomic>
+
+#include "coloring_base.h"
+#include "asynch_naive.h"
+#include "jones_plassmann.h"
+
+// One TabuCol search (Hertz and de Werra) for a coloring with colors
+// [0, k). neighborColors[v*k + c] counts the neighbours of v with color c
+// and is updated incrementally over the neighbour list of every moved
+// vertex, so v is in conflict exactly when neighborColors[v*k + color(v)]
+// is non-zero. Every step moves a conflicting vertex to the color that
+// removes the most conflicts, among moves that are not tabu or that give
+// fewer conflicts than ever before. Moving v away from color c makes
+// (v, c) tabu for a random base tenure plus 0.6 times the number of
+// conflicting vertices. The palette needs at least two colors.
+template <class vertex>
+class TabuSearch
+{
+public:
+    // Bytes of counters and tabu tenures a search over n vertices allocates
+    static size_t bytesPerSearch(size_t n, uintT k)
+    {
+        return n * k * (sizeof(uintT) + sizeof(uint64_t)) + n * 2 * sizeof(uintT);
+    }
+
+    TabuSearch(graph<vertex> &GA, colorVector &colors, uintT k, uint64_t seed) :
+        GA(GA), colors(colors), k(k), numVertices(GA.n), rng(seed)
+    {
+        neighborColors = newA(uintT, numVertices * k);
+        tabuUntil = newA(uint64_t, numVertices * k);
+        conflictPos = newA(uintT, numVertices);
+        memset(neighborColors, 0, numVertices * k * sizeof(uintT));
+        memset(tabuUntil, 0, numVertices * k * sizeof(uint64_t));
+        conflicts = 0;
+        for (size_t v_i = 0; v_i < numVertices; v_i++)
+        {
+            const uintT vDegree = GA.V[v_i].getOutDegree();
+            for (uintT n_i = 0; n_i < vDegree; n_i++)
+            {
+                uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+                neighborColors[v_i * k + colors[neigh]]++;
+                if (colors[neigh] == colors[v_i] && neigh < v_i)
+                    conflicts++;
+            }
+        }
+        for (size_t v_i = 0; v_i < numVertices; v_i++)
+        {
+            conflictPos[v_i] = UINT_T_MAX;
+            updateConflicting(v_i);
+        }
+        bestConflicts = conflicts;
+    }
+
+    ~TabuSearch()
+    {
+        free(neighborColors);
+        free(tabuUntil);
+        free(conflictPos);
+    }
+
+    // Runs until no conflict is left, maxIters steps were taken, the time
+    // limit passed or another search set stop. The number of conflicting
+    // edges is recorded every reportEvery steps. Returns the conflicts left.
+    size_t run(uint64_t maxIters, double timeLimit, std::atomic<bool> &stop, uint64_t reportEvery)
+    {
+        timer searchTimer;
+        const double startTime = searchTimer.getTime();
+        trace.push_back(std::make_pair(0.0, conflicts));
+        for (steps = 0; steps < maxIters && conflicts > 0; steps++)
+        {
+            if (steps % 1024 == 0)
+            {
+                if (stop.load(std::memory_order_relaxed))
+                    break;
+                if (timeLimit > 0 && searchTimer.getTime() - startTime > timeLimit)
+                    break;
+            }
+            step();
+            if (conflicts < bestConflicts)
+                bestConflicts = conflicts;
+            if ((steps + 1) % reportEvery == 0)
+                trace.push_back(std::make_pair(searchTimer.getTime() - startTime, conflicts));
+        }
+        trace.push_back(std::make_pair(searchTimer.getTime() - startTime, conflicts));
+        return conflicts;
+    }
+
+    uint64_t iterations() const
+    {
+        return steps;
+    }
+
+    // (seconds, conflicting edges) pairs recorded by run
+    const std::vector<std::pair<double, size_t>> &conflictTrace() const
+    {
+        return trace;
+    }
+
+private:
+    TabuSearch(const TabuSearch&);
+    TabuSearch& operator=(const TabuSearch&);
+
+    // Keep the list of conflicting vertices in sync with the counters of v
+    inline void updateConflicting(uintT v_i)
+    {
+        const bool conflicting = neighborColors[(size_t) v_i * k + colors[v_i]] > 0;
+        if (conflicting && conflictPos[v_i] == UINT_T_MAX)
+        {
+            conflictPos[v_i] = conflictList.size();
+            conflictList.push_back(v_i);
+        }
+        else if (!conflicting && conflictPos[v_i] != UINT_T_MAX)
+        {
+            uintT last = conflictList.back();
+            conflictList[conflictPos[v_i]] = last;
+            conflictPos[last] = conflictPos[v_i];
+            conflictList.pop_back();
+            conflictPos[v_i] = UINT_T_MAX;
+        }
+    }
+
+    void step()
+    {
+        // Best allowed move, ties broken at random
+        long bestDelta = LONG_MAX;
+        uintT bestVertex = UINT_T_MAX, bestColor = 0, ties = 0;
+        for (size_t c_i = 0; c_i < conflictList.size(); c_i++)
+        {
+            const uintT v_i = conflictList[c_i];
+            const uintT* counts = neighborColors + (size_t) v_i * k;
+            const long current = counts[colors[v_i]];
+            for (uintT color = 0; color < k; color++)
+            {
+                if (color == colors[v_i])
+                    continue;
+                const long delta = (long) counts[color] - current;
+                const bool tabu = tabuUntil[(size_t) v_i * k + color] > steps;
+                if (tabu && (long) conflicts + delta >= (long) bestConflicts)
+                    continue;
+                if (delta < bestDelta)
+                {
+                    bestDelta = delta;
+                    bestVertex = v_i;
+                    bestColor = color;
+                    ties = 1;
+                }
+                else if (delta == bestDelta && rng() % ++ties == 0)
+                {
+                    bestVertex = v_i;
+                    bestColor = color;
+                }
+            }
+        }
+
+        // Every move is tabu: take a random one
+        if (bestVertex == UINT_T_MAX && k > 1)
+        {
+            bestVertex = conflictList[rng() % conflictList.size()];
+            bestColor = (colors[bestVertex] + 1 + rng() % (k - 1)) % k;
+        }
+        if (bestVertex != UINT_T_MAX)
+            move(bestVertex, bestColor);
+    }
+
+    void move(uintT v_i, uintT newColor)
+    {
+        const uintT oldColor = colors[v_i];
+        conflicts += (long) neighborColors[(size_t) v_i * k + newColor]
+                   - (long) neighborColors[(size_t) v_i * k + oldColor];
+        colors[v_i] = newColor;
+        tabuUntil[(size_t) v_i * k + oldColor] = steps + rng() % 10 + (uint64_t) (0.6 * conflictList.size());
+
+        const uintT vDegree = GA.V[v_i].getOutDegree();
+        for (uintT n_i = 0; n_i < vDegree; n_i++)
+        {
+            uintT neigh = GA.V[v_i].getOutNeighbor(n_i);
+            neighborColors[(size_t) neigh * k + oldColor]--;
+            neighborColors[(size_t) neigh * k + newColor]++;
+            if (colors[neigh] == oldColor || colors[neigh] == newColor)
+                updateConflicting(neigh);
+        }
+        updateConflicting(v_i);
+    }
+
+    graph<vertex> &GA;
+    colorVector &colors;
+    const uintT k;
+    const size_t numVertices;
+    std::mt19937_64 rng;
+    uintT* neighborColors;
+    uint64_t* tabuUntil;
+    uintT* conflictPos;
+    std::vector<uintT> conflictList;
+    size_t conflicts;
+    size_t bestConflicts;
+    uint64_t steps;
+    std::vector<std::pair<double, size_t>> trace;
+};
+
+// Move every vertex with a color >= k to the color in [0, k) fewest of
+// its neighbours have
+template <class vertex>
+void reducePalette(graph<vertex> &GA, colorVector &colorData, uintT k)
+{
+    std::vector<uintT> counts(k);
+    for (size_t v_i = 0; v_i < (size_t) GA.n; v_i++)
+    {
+        if (colorData[v_i] < k)
+            continue;
+        std::fill(counts.begin(), counts.end(), 0);
+        mapNeighborColors(GA.V[v_i], colorData, [&] (uintT neighVal)
+        {
+            if (neighVal < k)
+                counts[neighVal]++;
+        });
+        colorData[v_i] = std::min_element(counts.begin(), counts.end()) - counts.begin();
+    }
+}
+
+// Fixed palette k-coloring. A start coloring from the naive engine (or
+// Jones-Plassmann with -start jp) is reduced to -k colors, one fewer than
+// it uses by default, and repaired by -searches independent TabuCol
+// searches (one per worker by default) run in parallel with different
+// seeds. The first search to remove every conflict wins and stops the
+// others. Searches beyond what fits in -search-mb megabytes (4096 by
+// default) are dropped. Each search runs for at most -max-iters steps and
+// -time-limit-ms milliseconds (2000 by default, 0 for no limit), as the
+// palette may be infeasible. The conflicts of the winning search, or of
+// the best one, are reported every -report-every steps. Without a
+// k-coloring the valid start coloring is kept and assessed instead.
+template <class vertex>
+void Compute(graph<vertex> &GA, commandLine P)
+{
+    timer fullTimer;
+    fullTimer.start();
+
+    // Check that graph is undirected (out degree == in degree for all vertices)
+    ensureUndirected(GA, P);
+
+    const size_t numVertices = GA.n;
+    const uintT maxDegree = getMaxDeg(GA);
+    colorVector colorData = makeColorVector(numVertices, maxDegree);
+
+    // Verbose variables
+    bool verbose = true;
+
+    if (P.getOptionValue("-start", string("naive")) == "jp")
+        colorJonesPlassmann(GA, colorData, maxDegree, false);
+    else
+        colorAsynchNaive(GA, colorData, maxDegree, P, false);
+    const uintT startColors = countColors(colorData);
+    const uintT k = P.getOptionLongValue("-k", std::max(startColors, (uintT) 2) - 1);
+    if (verbose)
+    {
+        std::cout << "Start Colors: " << startColors << std::endl;
+        std::cout << "Palette: " << k << std::endl;
+    }
+
+    if (k == 0)
+    {
+        cout << "The palette needs at least one color. Exiting..." << endl;
+        exit(2);
+    }
+    // A k-coloring found by the searches is valid but not first-fit,
+    // unlike the start coloring
+    bool firstFit = true;
+    if (k == 1 && startColors > 1)
+    {
+        // Any edge needs two colors, so there is nothing to search for
+        if (verbose)
+            std::cout << "No 1-coloring: the graph has edges" << std::endl;
+    }
+    else if (k < startColors)
+    {
+        colorVector startColoring(colorData);
+        reducePalette(GA, colorData, k);
+
+        long searches = std::max(1L, P.getOptionLongValue("-searches", getWorkers()));
+        const size_t searchBytes = TabuSearch<vertex>::bytesPerSearch(numVertices, k);
+        const size_t memoryLimit = (size_t) std::max(1L, P.getOptionLongValue("-search-mb", 4096)) << 20;
+        const long fitting = std::max((size_t) 1, memoryLimit / std::max(searchBytes, (size_t) 1));
+        if (searches > fitting)
+        {
+            if (verbose)
+            {
+                std::cout << "Searches: " << searches << " need " << (searches * searchBytes >> 20)
+                          << " MB, running " << fitting << std::endl;
+            }
+            searches = fitting;
+        }
+        const uint64_t maxIters = P.getOptionLongValue("-max-iters", 10000000);
+        const double timeLimit = P.getOptionLongValue("-time-limit-ms", 2000) / 1000.0;
+        const uint64_t reportEvery = std::max(1L, P.getOptionLongValue("-report-every", 10000));
+        const uint64_t seed = P.getOptionLongValue("-seed", 1);
+
+        std::vector<colorVector> results(searches, colorData);
+        std::vector<size_t> conflictsLeft(searches);
+        std::vector<uint64_t> iterations(searches);
+        std::vector<std::vector<std::pair<double, size_t>>> traces(searches);
+        std::atomic<bool> found(false);
+        std::atomic<long> winner(-1);
+        parallel_for_1 (0, searches, [&] (long s_i)
+        {
+            TabuSearch<vertex> search(GA, results[s_i], k, pbbs::hash64(seed + s_i));
+            conflictsLeft[s_i] = search.run(maxIters, timeLimit, found, reportEvery);
+            iterations[s_i] = search.iterations();
+            traces[s_i] = search.conflictTrace();
+            long none = -1;
+            if (conflictsLeft[s_i] == 0 && winner.compare_exchange_strong(none, s_i))
+                found.store(true);
+        });
+
+        long best = winner.load();
+        if (best < 0)
+            best = std::min_element(conflictsLeft.begin(), conflictsLeft.end()) - conflictsLeft.begin();
+        const colorVector &kept = (winner.load() >= 0) ? results[best] : startColoring;
+        parallel_for (0, numVertices, [&] (size_t v_i)
+        {
+            colorData[v_i] = kept[v_i];
+        });
+        firstFit = (winner.load() < 0);
+
+        if (verbose)
+        {
+            for (long s_i = 0; s_i < searches; s_i++)
+            {
+                std::cout << "Search " << s_i << ": " << iterations[s_i] << " steps, "
+                          << conflictsLeft[s_i] << " conflicts left" << std::endl;
+            }
+            if (winner.load() >= 0)
+                std::cout << "Found a " << k << "-coloring, search " << best << std::endl;
+            else
+            {
+                std::cout << "No " << k << "-coloring found, best search " << best << " left "
+                          << conflictsLeft[best] << " conflicts" << std::endl;
+                std::cout << "Keeping the start coloring with " << startColors << " colors" << std::endl;
+            }
+            std::cout << "Conflicts over time:" << std::endl;
+            for (size_t t_i = 0; t_i < traces[best].size(); t_i++)
+            {
+                std::cout << "\t" << setprecision(TIME_PRECISION) << traces[best][t_i].first
+                          << "\t" << traces[best][t_i].second << std::endl;
+            }
+        }
+        benchCounters.iterations = iterations[best];
+    }
+
+    if (verbose)
+    {
+        cout << "\nTotal Time : " << setprecision(TIME_PRECISION) << fullTimer.stop() << "\n";
+    }
+
+    // Post-process (-kempe, -balance) and assess graph
+    finishColoring(GA, colorData, maxDegree, P, firstFit);
+}